@@ -8,7 +8,6 @@
 #include <string>
 #include <iomanip>
 #include <cstdio>
-#include <conio.h> // For _getch()
 #include <ctime>
 #include <cstdlib>
 #include <vector>
@@ -16,1163 +15,9979 @@
 #include <queue>
 #include <stack>
 #include <algorithm>
-#include <windows.h> // For SetConsoleTextAttribute and Sleep
 #include <functional> // For std::function
 #include <limits>     // For numeric_limits
+#include <thread>     // For parallel analytics workers
+#include <chrono>     // For timing analytics runs
+#include <array>
+#include <cmath>      // For llround
+#include <sstream>
+#include <unordered_map>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <coroutine> // Server sessions (C++20)
+#include <random>
+#include <memory>
+#include <set>
+#include <numeric> // For iota
+#include <filesystem> // For resize_file in standing order recovery
+#ifdef _WIN32
+#include <conio.h>   // For _getch()
+#include <windows.h> // For MoveFileExA and enabling ANSI escapes in the console
+#include <io.h>      // For _commit
+#else
+#include <unistd.h>    // For fsync
+#include <termios.h>   // For reading single keys without echo
+#include <sys/ioctl.h> // For the terminal size
+#endif
+#ifdef __linux__
+#include <sys/epoll.h> // Server mode event loop
+#include <sys/eventfd.h> // Wakes an event loop when a password check finishes
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/mman.h> // Startup loads map Bank_Record.csv
+#include <cerrno>
+#endif
 
 using namespace std;
 
 // Global variables (reduced reliance where possible)
-HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+// Console renderer. cout writes into the current frame instead of the console; the frame is shown
+// when input is read or the stream is flushed, in one write. clearScreen() starts a new frame, and
+// the first time it is shown only the lines that differ from the previous frame are rewritten
+// (ANSI cursor moves), so a screen change costs one small write instead of a "cls" process.
+// Colors are ANSI escapes as well, so no console API is called. Lines the user typed are echoed
+// by the terminal; cin goes through EchoTracker so the frame keeps matching what is on screen.
+class TerminalRenderer : public streambuf
+{
+public:
+    // Route cout/cin through the renderer (idempotent; main() runs again after a logout)
+    void attach()
+    {
+        if (original_out != nullptr)
+            return;
+#ifdef _WIN32
+        HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD mode = 0;
+        if (GetConsoleMode(console, &mode))
+            SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+        styled = _isatty(_fileno(stdout)) != 0;
+        echoing = styled && _isatty(_fileno(stdin)) != 0;
+#else
+        styled = isatty(STDOUT_FILENO) != 0;
+        echoing = styled && isatty(STDIN_FILENO) != 0;
+#endif
+        original_out = cout.rdbuf(this);
+        echo_tracker.owner = this;
+        echo_tracker.source = cin.rdbuf(&echo_tracker);
+    }
+
+    ~TerminalRenderer()
+    {
+        if (original_out == nullptr)
+            return;
+        present();
+        cout.rdbuf(original_out);
+        cin.rdbuf(echo_tracker.source);
+    }
+
+    // Start a new frame (what "cls" used to do)
+    void clearScreen()
+    {
+        lock_guard<mutex> guard(lock);
+        if (repaint && frame.empty())
+            return; // Already cleared and nothing drawn since; keep diffing against the old screen
+        presentLocked();
+        screen = splitLines(frame);
+        screen_valid = frame_from_top && fits(screen);
+        frame.clear();
+        shown = 0;
+        repaint = true;
+        frame_from_top = true;
+    }
+
+    // SGR escape for a Windows console attribute (low nibble: blue, green, red, intensity)
+    void setColor(int color)
+    {
+        if (!styled)
+            return;
+        int ansi = ((color & 4) ? 1 : 0) | ((color & 2) ? 2 : 0) | ((color & 1) ? 4 : 0);
+        string sgr = color == 7 ? "\x1b[0m" : "\x1b[0;" + to_string(((color & 8) ? 90 : 30) + ansi) + "m";
+        sputn(sgr.data(), static_cast<streamsize>(sgr.size()));
+    }
+
+    void present()
+    {
+        lock_guard<mutex> guard(lock);
+        presentLocked();
+    }
+
+protected:
+    int overflow(int ch) override
+    {
+        if (ch == EOF)
+            return 0;
+        char c = static_cast<char>(ch);
+        return xsputn(&c, 1) == 1 ? ch : EOF;
+    }
+
+    streamsize xsputn(const char *data, streamsize count) override
+    {
+        lock_guard<mutex> guard(lock);
+        frame.append(data, static_cast<size_t>(count));
+        // Long jobs that print as they go still show progress
+        if (chrono::steady_clock::now() - last_present > chrono::milliseconds(100))
+            presentLocked();
+        return count;
+    }
+
+    int sync() override
+    {
+        present();
+        return 0;
+    }
+
+private:
+    struct Line
+    {
+        string style; // SGR in effect where the line starts
+        string text;
+        bool operator==(const Line &other) const { return style == other.style && text == other.text; }
+    };
+
+    // Feeds cin from the real stdin and records each character in the frame, because the
+    // terminal has already echoed it there
+    struct EchoTracker : streambuf
+    {
+        streambuf *source = nullptr;
+        TerminalRenderer *owner = nullptr;
+        char current = 0;
+
+        int underflow() override
+        {
+            int ch = source->sbumpc();
+            if (ch == EOF)
+                return EOF;
+            current = static_cast<char>(ch);
+            setg(&current, &current, &current + 1);
+            if (owner->echoing)
+            {
+                lock_guard<mutex> guard(owner->lock);
+                owner->frame += current;
+                owner->shown = owner->frame.size();
+            }
+            return static_cast<unsigned char>(current);
+        }
+    };
+
+    void presentLocked()
+    {
+        last_present = chrono::steady_clock::now();
+        if (shown == frame.size() && !repaint)
+            return;
+        string out;
+        if (!repaint || !styled)
+        {
+            out.assign(frame, shown, string::npos);
+        }
+        else
+        {
+            vector<Line> lines = splitLines(frame);
+            if (!screen_valid || !fits(lines))
+            {
+                out = "\x1b[0m\x1b[H\x1b[2J" + frame; // Full repaint
+            }
+            else
+            {
+                // Rewrite changed lines in place; the last line is always rewritten so the
+                // cursor ends where the frame ends, then whatever is below is cleared
+                for (size_t i = 0; i < lines.size(); i++)
+                {
+                    if (i + 1 < lines.size() && i < screen.size() && lines[i] == screen[i])
+                        continue;
+                    out += "\x1b[" + to_string(i + 1) + ";1H\x1b[0m" + lines[i].style + lines[i].text;
+                    out += i + 1 < lines.size() ? "\x1b[K" : "\x1b[J";
+                }
+            }
+            repaint = false;
+        }
+        shown = frame.size();
+        writeAll(out);
+    }
+
+    static void writeAll(const string &out)
+    {
+        size_t done = 0;
+        while (done < out.size())
+        {
+#ifdef _WIN32
+            int n = _write(1, out.data() + done, static_cast<unsigned>(out.size() - done));
+#else
+            ssize_t n = write(STDOUT_FILENO, out.data() + done, out.size() - done);
+#endif
+            if (n <= 0)
+                return;
+            done += static_cast<size_t>(n);
+        }
+    }
+
+    // Split on newlines, noting the SGR in effect at the start of each line
+    static vector<Line> splitLines(const string &text)
+    {
+        vector<Line> lines(1);
+        string style;
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            if (text[i] == '\n')
+            {
+                lines.push_back({style, ""});
+                continue;
+            }
+            if (text[i] == '\x1b' && i + 1 < text.size() && text[i + 1] == '[')
+            {
+                size_t end = text.find('m', i);
+                if (end != string::npos)
+                {
+                    style = text.substr(i, end - i + 1);
+                    lines.back().text.append(style);
+                    i = end;
+                    continue;
+                }
+            }
+            lines.back().text += text[i];
+        }
+        return lines;
+    }
+
+    // True if the lines fit the terminal without wrapping or scrolling
+    static bool fits(const vector<Line> &lines)
+    {
+        int rows = 24, cols = 80;
+#ifdef _WIN32
+        CONSOLE_SCREEN_BUFFER_INFO info;
+        if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info))
+        {
+            rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+            cols = info.srWindow.Right - info.srWindow.Left + 1;
+        }
+#else
+        winsize size{};
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0)
+        {
+            rows = size.ws_row;
+            cols = size.ws_col;
+        }
+#endif
+        if (static_cast<int>(lines.size()) >= rows)
+            return false;
+        for (const Line &line : lines)
+        {
+            int width = 0;
+            for (size_t i = 0; i < line.text.size(); i++)
+            {
+                char c = line.text[i];
+                if (c == '\x1b')
+                {
+                    size_t end = line.text.find('m', i);
+                    i = end == string::npos ? line.text.size() : end;
+                }
+                else if (c == '\t')
+                    width = (width / 8 + 1) * 8;
+                else if (c == '\b')
+                    width = max(0, width - 1);
+                else if (c != '\r')
+                    width++;
+            }
+            if (width >= cols)
+                return false;
+        }
+        return true;
+    }
+
+    mutex lock; // Worker threads may print too
+    streambuf *original_out = nullptr;
+    EchoTracker echo_tracker;
+    bool styled = false;  // stdout is a terminal: colors and cursor moves are allowed
+    bool echoing = false; // stdin is a terminal that echoes typed lines
+    string frame;         // Text of the current frame, as it appears on screen
+    size_t shown = 0;     // Bytes of frame already written
+    bool repaint = false; // A new frame has not been shown yet
+    bool frame_from_top = false; // The frame began at the top-left corner
+    vector<Line> screen;  // Lines of the previous frame
+    bool screen_valid = false;
+    chrono::steady_clock::time_point last_present;
+};
+TerminalRenderer terminal;
+
+// Account listing settings
+const size_t LISTING_PAGE_SIZE = 20;         // Default rows per page in displayAllAccounts
+const size_t EXPORT_FLUSH_BYTES = 1 << 16;   // Export buffer is written to disk in blocks of this size
 
 // Data structures
 map<string, string> accountCredentials;  // Hash table for account credentials
 map<string, string> employeeCredentials; // Hash table for employee credentials
 vector<string> transactionHistory;       // Vector to store transaction history (all transactions)
-queue<string> serviceQueue;              // Queue for customer service requests
 stack<string> recentTransactions;        // Stack for recent transactions (last 10 shown to user)
 
-// Forward declarations
-void fordelay(int);
-void close_application(void);
-int main();
-void showEmployeeMenu();
-void employeeLogin();
-void customerLogin();
-void showCustomerMenu();
-void displayAppTitle();
-void showLoginPage();
-void showSignupPage();
-void showInstructions();
-void showLoadingScreen();
-void setConsoleColor(int color);
-void loadAllCredentials();
-void saveAllCredentials();
-string getSecurePasswordInput();
-string getCurrentDateTime(); // Helper to get current date/time
+// Structured ledger entry (persisted to Transaction_log.csv, used for analytics)
+struct LedgerEntry
+{
+    time_t timestamp;
+    string kind;          // Deposit, Withdrawal or Transfer
+    string account;       // Account the money moved in/out of (sender for transfers)
+    string counterparty;  // Recipient for transfers, empty otherwise
+    long long amount;     // Amount in paise (1/100 Rs) to avoid float drift
+};
+vector<LedgerEntry> transactionLedger;   // All ledger entries, in commit order
 
-// Bank Account Class
-class Bank
+// In-memory log of committed changes streamed to read replicas. Records are
+// "<seq>,<commit_time_us>,<payload>" where payload is "L,<ledger entry>" or "O,<account record>,<password>".
+class ReplicationLog
 {
+public:
+    // Called with the bank lock held, so sequence order is commit order
+    void publish(const string &payload)
+    {
+        long long commit_us = chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count();
+        lock_guard<mutex> guard(lock);
+        records.push_back(to_string(base + records.size() + 1) + "," + to_string(commit_us) + "," + payload);
+        trim();
+        changed.notify_all();
+    }
+
+    // Start following the log from its end (call with the bank lock held, next to the snapshot
+    // that covers everything before it); returns the follower's id and sets 'from'
+    int follow(size_t &from)
+    {
+        lock_guard<mutex> guard(lock);
+        from = base + records.size();
+        followers[next_follower] = from;
+        return next_follower++;
+    }
+
+    void unfollow(int follower)
+    {
+        lock_guard<mutex> guard(lock);
+        followers.erase(follower);
+        trim();
+    }
+
+    // Copy the records after the first 'from' into 'out', waiting up to 'timeout' for new ones.
+    // 'from' also tells the log this follower is done with the earlier records. Returns false once
+    // the log is closed.
+    bool waitForRecords(int follower, size_t from, vector<string> &out, chrono::milliseconds timeout)
+    {
+        unique_lock<mutex> guard(lock);
+        followers[follower] = from;
+        trim();
+        changed.wait_for(guard, timeout, [&] { return closed || base + records.size() > from; });
+        out.assign(records.begin() + static_cast<ptrdiff_t>(from - base), records.end());
+        return !closed;
+    }
+
+    void close()
+    {
+        lock_guard<mutex> guard(lock);
+        closed = true;
+        changed.notify_all();
+    }
+
 private:
-    struct AccountNode
+    mutex lock;
+    condition_variable changed;
+    deque<string> records; // Sequence numbers base + 1 onwards
+    size_t base = 0;       // Records dropped so far
+    map<int, size_t> followers; // Follower id -> records it has sent
+    int next_follower = 0;
+    bool closed = false;
+
+    // Drop the records every follower has sent. A replica that reconnects starts from a new
+    // snapshot, so nothing reads them again; with no followers everything goes.
+    void trim()
     {
-        string account_number;
-        string name;
-        string dob;
-        string age;
-        string address;
-        string phone;
-        string balance;
-        string acc_type;
-        string creation_date;
-        string last_transaction;
-        AccountNode *left;
-        AccountNode *right;
-
-        // Constructor for AccountNode
-        AccountNode(string acc_no, string n, string d, string a,
-                    string addr, string ph, string bal, string type,
-                    string date, string last_trans_date)
-            : account_number(acc_no), name(n), dob(d), age(a),
-              address(addr), phone(ph), balance(bal), acc_type(type),
-              creation_date(date), last_transaction(last_trans_date), left(nullptr), right(nullptr) {}
-    };
+        size_t keep_from = base + records.size();
+        for (const auto &follower : followers)
+            keep_from = min(keep_from, follower.second);
+        records.erase(records.begin(), records.begin() + static_cast<ptrdiff_t>(keep_from - base));
+        base = keep_from;
+    }
+};
+ReplicationLog *replicationLog = nullptr; // Set while this process is a primary with replicas
 
-    AccountNode *root; // Root of the BST
+// Outcome of a non-interactive money movement (shared by the console flows and server mode)
+enum class TxnStatus
+{
+    Ok,
+    NoSuchAccount,
+    NoSuchRecipient,
+    SameAccount,
+    InvalidAmount,
+    InsufficientFunds,
+    StorageError,
+    VelocityLimit
+};
 
-    // Private helper for inserting into BST
-    AccountNode *insert(AccountNode *node, const string &acc_no, const string &n, const string &d, const string &a,
-                        const string &addr, const string &ph, const string &bal, const string &type, const string &date, const string &last_trans_date)
+// Outflow limits checked before a withdrawal or transfer commits (Velocity_rules.csv); 0 = no limit.
+// Windows are the last minute, hour and day.
+const int VELOCITY_WINDOWS = 3;
+const int MAX_TRACKED_COUNTERPARTIES = 16;
+struct VelocityRules
+{
+    array<int, VELOCITY_WINDOWS> max_count{};
+    array<long long, VELOCITY_WINDOWS> max_amount{}; // Paise
+    int max_counterparties_day = 0;                  // Distinct recipients, at most MAX_TRACKED_COUNTERPARTIES
+};
+
+// Count and sum over a sliding window of BUCKETS buckets; the caller advances it to the current
+// bucket number, which retires the expired buckets (amortized O(1) per transaction).
+template <int BUCKETS>
+struct RingCounter
+{
+    long long sum = 0;
+    int count = 0;
+    int head = 0; // Bucket number of the newest bucket
+    array<unsigned short, BUCKETS> counts{}; // Per-bucket counts saturate nowhere near a 5 s..1 h bucket's volume
+    array<long long, BUCKETS> sums{};
+
+    void advance(int bucket)
     {
-        if (node == nullptr)
+        if (bucket <= head)
+            return;
+        if (bucket - head >= BUCKETS)
         {
-            return new AccountNode(acc_no, n, d, a, addr, ph, bal, type, date, last_trans_date);
+            counts.fill(0);
+            sums.fill(0);
+            count = 0;
+            sum = 0;
         }
-        if (acc_no < node->account_number)
+        else
         {
-            node->left = insert(node->left, acc_no, n, d, a, addr, ph, bal, type, date, last_trans_date);
+            for (int b = head + 1; b <= bucket; b++)
+            {
+                int slot = b % BUCKETS;
+                count -= counts[slot];
+                sum -= sums[slot];
+                counts[slot] = 0;
+                sums[slot] = 0;
+            }
         }
-        else if (acc_no > node->account_number) // Added check for greater to avoid duplicates or issues
+        head = bucket;
+    }
+
+    void add(long long amount)
+    {
+        int slot = head % BUCKETS;
+        counts[slot]++;
+        sums[slot] += amount;
+        count++;
+        sum += amount;
+    }
+};
+
+// Inline fraud/velocity rule engine: per-account outflow aggregates for the last minute (12 x 5 s
+// buckets), hour (12 x 5 min) and day (24 x 1 h) plus the distinct recipients of the last day.
+class VelocityMonitor
+{
+public:
+    VelocityRules rules;
+
+    // Admit an outflow and count it, or return the rule it breaks (nothing is counted then)
+    const char *admit(const string &acc_no, long long amount, const string &counterparty, time_t now)
+    {
+        if (checkpoint != nullptr)
+            saveWindows(acc_no);
+        AccountWindows &windows = windowsFor(acc_no, now);
+        static const char *count_rules[VELOCITY_WINDOWS] = {"transactions per minute", "transactions per hour", "transactions per day"};
+        static const char *amount_rules[VELOCITY_WINDOWS] = {"amount per minute", "amount per hour", "amount per day"};
+        int counts[VELOCITY_WINDOWS] = {windows.minute.count, windows.hour.count, windows.day.count};
+        long long sums[VELOCITY_WINDOWS] = {windows.minute.sum, windows.hour.sum, windows.day.sum};
+        for (int w = 0; w < VELOCITY_WINDOWS; w++)
         {
-            node->right = insert(node->right, acc_no, n, d, a, addr, ph, bal, type, date, last_trans_date);
+            if (rules.max_count[w] > 0 && counts[w] + 1 > rules.max_count[w])
+                return count_rules[w];
+            if (rules.max_amount[w] > 0 && sums[w] + amount > rules.max_amount[w])
+                return amount_rules[w];
         }
-        return node;
+
+        int slot = -1;
+        if (!counterparty.empty())
+        {
+            unsigned tag = static_cast<unsigned>(std::hash<string>()(counterparty)) | 1u; // 0 marks an empty slot
+            int distinct = 0, reusable = 0;
+            int oldest = numeric_limits<int>::max();
+            for (int i = 0; i < MAX_TRACKED_COUNTERPARTIES; i++)
+            {
+                bool live = windows.counterparties[i] != 0 && windows.day.head - windows.counterparty_hour[i] < 24;
+                if (live && windows.counterparties[i] == tag)
+                    slot = i;
+                distinct += live;
+                int age_key = live ? windows.counterparty_hour[i] : numeric_limits<int>::min();
+                if (age_key < oldest)
+                {
+                    oldest = age_key;
+                    reusable = i;
+                }
+            }
+            if (slot < 0)
+            {
+                if (rules.max_counterparties_day > 0 && distinct + 1 > rules.max_counterparties_day)
+                    return "distinct recipients per day";
+                slot = reusable;
+                windows.counterparties[slot] = tag;
+            }
+            windows.counterparty_hour[slot] = windows.day.head;
+        }
+
+        windows.minute.add(amount);
+        windows.hour.add(amount);
+        windows.day.add(amount);
+        return nullptr;
     }
 
-    // Private helper for searching in BST
-    AccountNode *search(AccountNode *node, const string &acc_no)
+    // Rebuild the windows from the last day of the ledger (at startup)
+    void prime(const vector<LedgerEntry> &ledger, time_t now)
     {
-        if (node == nullptr || node->account_number == acc_no)
+        windows.clear();
+        VelocityRules configured = rules;
+        rules = VelocityRules{}; // All limits off: count history without judging it
+        for (const LedgerEntry &entry : ledger)
         {
-            return node;
+            if (now - entry.timestamp < 86400 && (entry.kind == "Withdrawal" || entry.kind == "Transfer"))
+                admit(entry.account, entry.amount, entry.counterparty, entry.timestamp);
         }
-        if (acc_no < node->account_number)
+        rules = configured;
+    }
+
+    size_t trackedAccounts() const { return windows.size(); }
+
+private:
+    struct AccountWindows
+    {
+        RingCounter<12> minute; // 5 s buckets
+        RingCounter<12> hour;   // 5 min buckets
+        RingCounter<24> day;    // 1 h buckets
+        array<unsigned, MAX_TRACKED_COUNTERPARTIES> counterparties{};
+        array<int, MAX_TRACKED_COUNTERPARTIES> counterparty_hour{}; // Day bucket (hour number) of the last transfer
+    };
+
+public:
+    // An account's windows before an admit() (existed = false: the account was not tracked yet)
+    struct SavedWindows
+    {
+        string acc_no;
+        bool existed;
+        AccountWindows windows;
+    };
+    // While set, admit() saves each account's windows here first, so a batch that cannot commit
+    // can undo its admissions with restore()
+    vector<SavedWindows> *checkpoint = nullptr;
+
+    // Put back the windows saved in 'saved' (newest first, so each account ends as it started)
+    void restore(const vector<SavedWindows> &saved)
+    {
+        for (auto it = saved.rbegin(); it != saved.rend(); ++it)
         {
-            return search(node->left, acc_no);
+            if (it->existed)
+                windows[it->acc_no] = it->windows;
+            else
+                windows.erase(it->acc_no);
         }
-        return search(node->right, acc_no);
     }
 
-    // Private helper for in-order traversal (for display_all)
-    void inorder(AccountNode *node)
+private:
+    void saveWindows(const string &acc_no)
     {
-        if (node != nullptr)
+        auto found = windows.find(acc_no);
+        bool existed = found != windows.end();
+        checkpoint->push_back({acc_no, existed, existed ? found->second : AccountWindows()});
+    }
+
+    AccountWindows &windowsFor(const string &acc_no, time_t now)
+    {
+        if (now - last_sweep >= 3600)
+            sweep(now);
+        AccountWindows &windows = this->windows[acc_no];
+        windows.minute.advance(static_cast<int>(now / 5)); // Bucket numbers fit an int until 2310
+        windows.hour.advance(static_cast<int>(now / 300));
+        windows.day.advance(static_cast<int>(now / 3600));
+        return windows;
+    }
+
+    // Hourly: forget accounts with no outflow in the last day so the table tracks active accounts only
+    void sweep(time_t now)
+    {
+        last_sweep = now;
+        for (auto it = windows.begin(); it != windows.end();)
         {
-            inorder(node->left);
-            cout << "\t" << left
-                 << setw(20) << node->account_number
-                 << setw(30) << node->name
-                 << setw(20) << node->acc_type
-                 << "Rs " << node->balance << "\n";
-            inorder(node->right);
+            if (now / 3600 - it->second.day.head >= 24)
+                it = windows.erase(it);
+            else
+                ++it;
         }
     }
 
-    // Private helper to deallocate BST memory
-    void clearTree(AccountNode *node)
+    unordered_map<string, AccountWindows> windows;
+    time_t last_sweep = 0;
+};
+VelocityMonitor velocityMonitor; // Shared by every Bank instance, like the ledger
+
+// Replies to recent keyed money movements, so a client that times out and retries gets the first
+// reply back instead of moving the money twice. Each key lands in the current time bucket; when
+// the clock enters a new bucket the oldest bucket's keys are dropped, so expiry is amortized over
+// inserts and the table never holds more than MAX_KEYS (a full table expires its oldest bucket early).
+class IdempotencyTable
+{
+public:
+    static const int TTL_BUCKETS = 10;
+    static const time_t BUCKET_SECONDS = 60; // Keys are remembered for 9-10 minutes
+    static const size_t MAX_KEYS = 1 << 20;
+
+    // Reply stored for 'key', nullptr if the key is new or has expired. 'request' is the rest of
+    // the command; reusing a key for a different request is reported through 'mismatch'.
+    const string *find(const string &key, const string &request, time_t now, bool &mismatch)
     {
-        if (node != nullptr)
+        advance(now);
+        mismatch = false;
+        auto found = entries.find(hashKey(key));
+        if (found == entries.end())
+            return nullptr;
+        if (found->second.request_hash != hashKey(request))
         {
-            clearTree(node->left);
-            clearTree(node->right);
-            delete node;
+            mismatch = true;
+            return nullptr;
         }
+        replays++;
+        return &found->second.reply;
     }
 
-    // Private helper to save accounts to file (recursive inorder traversal)
-    void saveAccountsToFileHelper(AccountNode *node, ofstream &file)
+    void remember(const string &key, const string &request, const string &reply, time_t now)
     {
-        if (node != nullptr)
+        advance(now);
+        if (entries.size() >= MAX_KEYS) // Full: expire the oldest bucket early
         {
-            saveAccountsToFileHelper(node->left, file);
-            file << node->account_number << "," << node->name << "," << node->dob << ","
-                 << node->age << "," << node->address << "," << node->phone << ","
-                 << node->balance << "," << node->acc_type << "," << node->creation_date << "," // Added creation date
-                 << node->last_transaction << "\n"; // Added last transaction date
-            saveAccountsToFileHelper(node->right, file);
+            expireBucket(oldest_bucket);
+            if (oldest_bucket < current_bucket)
+                oldest_bucket++;
         }
+        unsigned long long hash = hashKey(key);
+        if (entries.emplace(hash, Entry{hashKey(request), current_bucket, reply}).second)
+            buckets[current_bucket % TTL_BUCKETS].push_back(hash);
     }
 
-public:
-    // Constructor
-    Bank() : root(nullptr)
+    size_t size() const { return entries.size(); }
+    size_t replayCount() const { return replays; }
+
+private:
+    struct Entry
     {
-        loadAccountsFromFile();
+        unsigned long long request_hash;
+        long long bucket;
+        string reply;
+    };
+
+    static unsigned long long hashKey(const string &text) // 64-bit FNV-1a, keys are stored by hash only
+    {
+        unsigned long long hash = 14695981039346656037ULL;
+        for (unsigned char c : text)
+            hash = (hash ^ c) * 1099511628211ULL;
+        return hash;
     }
 
-    // Destructor
-    ~Bank()
+    void expireBucket(long long bucket)
     {
-        clearTree(root);
+        vector<unsigned long long> &keys = buckets[bucket % TTL_BUCKETS];
+        for (unsigned long long hash : keys)
+        {
+            auto found = entries.find(hash);
+            if (found != entries.end() && found->second.bucket == bucket)
+                entries.erase(found);
+        }
+        keys.clear();
     }
 
-    // Public method to load accounts from CSV
-    void loadAccountsFromFile()
+    void advance(time_t now)
     {
-        ifstream file("Bank_Record.csv");
-        if (!file.is_open())
+        long long bucket = static_cast<long long>(now / BUCKET_SECONDS);
+        if (current_bucket < 0 || bucket - current_bucket >= TTL_BUCKETS) // First use, or every key has aged out
         {
-            // If file doesn't exist, it's fine for first run, just return
+            entries.clear();
+            for (auto &keys : buckets)
+                keys.clear();
+            current_bucket = oldest_bucket = bucket;
             return;
         }
-
-        string line;
-        while (getline(file, line))
+        while (current_bucket < bucket)
         {
-            vector<string> tokens;
-            string token;
-            size_t start = 0;
-            size_t end = line.find(',');
+            current_bucket++;
+            // Entering a bucket slot reuses it, so whatever it held has aged out
+            for (; oldest_bucket <= current_bucket - TTL_BUCKETS; oldest_bucket++)
+                expireBucket(oldest_bucket);
+        }
+    }
 
-            while (end != string::npos)
-            {
-                tokens.push_back(line.substr(start, end - start));
-                start = end + 1;
-                end = line.find(',', start);
-            }
-            tokens.push_back(line.substr(start, end)); // Add the last token
+    unordered_map<unsigned long long, Entry> entries;
+    array<vector<unsigned long long>, TTL_BUCKETS> buckets; // Keys inserted per bucket, for expiry
+    long long current_bucket = -1, oldest_bucket = -1;
+    size_t replays = 0;
+};
 
-            if (tokens.size() >= 10) // Changed to 10 to include last_transaction
+// --- Password hashing ---
+// Passwords are stored as "$pbkdf2-sha256$<iterations>$<salt hex>$<hash hex>", PBKDF2-HMAC-SHA256
+// over a random 16-byte salt. The iteration count (Password_config.csv) is the cost of every guess
+// and every login; changing it affects hashes made afterwards, and a login with an older cost (or
+// with a plaintext entry from before hashing) stores a fresh hash.
+const unsigned DEFAULT_PASSWORD_ITERATIONS = 100000;
+const string PASSWORD_HASH_PREFIX = "$pbkdf2-sha256$";
+atomic<unsigned> passwordIterations{DEFAULT_PASSWORD_ITERATIONS};
+
+// SHA-256 (FIPS 180-4). Copyable, so HMAC keeps its two padded-key states and copies them per call.
+class Sha256
+{
+public:
+    void update(const unsigned char *data, size_t length)
+    {
+        total += length;
+        while (length > 0)
+        {
+            size_t take = min(length, sizeof(buffer) - buffered);
+            memcpy(buffer + buffered, data, take);
+            buffered += take;
+            data += take;
+            length -= take;
+            if (buffered == sizeof(buffer))
             {
-                // Ensure all fields are present
-                root = insert(root, tokens[0], tokens[1], tokens[2], tokens[3],
-                              tokens[4], tokens[5], tokens[6], tokens[7], tokens[8], tokens[9]);
+                compress(buffer);
+                buffered = 0;
             }
         }
-        file.close();
     }
 
-    // Public method to save accounts to CSV
-    void saveAccountsToFile()
+    void finish(unsigned char digest[32])
     {
-        ofstream file("Bank_Record.csv");
-        if (!file.is_open())
+        unsigned long long bits = total * 8;
+        unsigned char padding[72] = {0x80};
+        size_t pad = (buffered < 56 ? 56 : 120) - buffered;
+        for (int i = 0; i < 8; i++)
+            padding[pad + i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+        update(padding, pad + 8);
+        for (int i = 0; i < 8; i++)
         {
-            setConsoleColor(12);
-            cout << "\n\tError: Could not open Bank_Record.csv for saving accounts.";
-            setConsoleColor(7);
-            return;
+            digest[4 * i] = static_cast<unsigned char>(state[i] >> 24);
+            digest[4 * i + 1] = static_cast<unsigned char>(state[i] >> 16);
+            digest[4 * i + 2] = static_cast<unsigned char>(state[i] >> 8);
+            digest[4 * i + 3] = static_cast<unsigned char>(state[i]);
         }
-
-        saveAccountsToFileHelper(root, file);
-        file.close();
     }
 
-    // Public method to create a new account
-    void createNewAccount();
-    // Public method to modify an existing account
-    void modifyAccountDetails();
-    // Public method to search for an account
-    void searchAccountRecord();
-    // Public method for deposit/withdrawal transactions
-    void handleDepositWithdrawal();
-    // Public method to display all accounts (for employees)
-    void displayAllAccounts();
-    // Public method for fund transfers
-    void performFundTransfer();
-    // Public method to view transaction history
-    void viewTransactionHistory();
-    // Public method for customer to request service
-    void submitServiceRequest();
-    // Public method for employees to process service requests
-    void manageServiceQueue();
-};
+private:
+    static uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
 
-// --- Utility Functions Implementation ---
+    void compress(const unsigned char block[64])
+    {
+        static const uint32_t K[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++)
+        {
+            w[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) |
+                   (uint32_t(block[4 * i + 2]) << 8) | uint32_t(block[4 * i + 3]);
+        }
+        for (int i = 16; i < 64; i++)
+        {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; i++)
+        {
+            uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
 
-// A simple delay function (using Sleep for better precision than a busy-wait loop)
-void fordelay(int milliseconds)
+    uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    unsigned char buffer[64];
+    size_t buffered = 0;
+    unsigned long long total = 0;
+};
+
+// PBKDF2-HMAC-SHA256 with a single 32-byte output block. Each iteration is two compressions: the
+// key-padded inner and outer states are computed once and copied.
+void pbkdf2Sha256(const string &password, const unsigned char *salt, size_t salt_length, unsigned iterations, unsigned char out[32])
 {
-    Sleep(milliseconds);
+    unsigned char key[64] = {0};
+    if (password.size() > sizeof(key))
+    {
+        Sha256 long_key;
+        long_key.update(reinterpret_cast<const unsigned char *>(password.data()), password.size());
+        long_key.finish(key);
+    }
+    else
+        memcpy(key, password.data(), password.size());
+    unsigned char pad[64];
+    Sha256 inner, outer;
+    for (int i = 0; i < 64; i++)
+        pad[i] = key[i] ^ 0x36;
+    inner.update(pad, 64);
+    for (int i = 0; i < 64; i++)
+        pad[i] = key[i] ^ 0x5c;
+    outer.update(pad, 64);
+
+    auto hmac = [&](const unsigned char *message, size_t length, const unsigned char *tail, size_t tail_length, unsigned char mac[32])
+    {
+        Sha256 first = inner, second = outer;
+        first.update(message, length);
+        first.update(tail, tail_length);
+        unsigned char inner_digest[32];
+        first.finish(inner_digest);
+        second.update(inner_digest, 32);
+        second.finish(mac);
+    };
+    static const unsigned char BLOCK_ONE[4] = {0, 0, 0, 1};
+    unsigned char u[32];
+    hmac(salt, salt_length, BLOCK_ONE, 4, u);
+    memcpy(out, u, 32);
+    for (unsigned i = 1; i < iterations; i++)
+    {
+        hmac(u, 32, nullptr, 0, u);
+        for (int j = 0; j < 32; j++)
+            out[j] ^= u[j];
+    }
 }
 
-// Function to safely close the application
-void close_application(void)
+static string toHex(const unsigned char *bytes, size_t length)
 {
-    displayAppTitle();
-    setConsoleColor(12);
-    cout << "\n\n\n\n\t\tThank you for using our banking system!";
-    setConsoleColor(7);
-    cout << "\n\n\t\tProgram is now closing...\n\n";
-    fordelay(2000); // Small delay before exiting
-    exit(0);
+    static const char DIGITS[] = "0123456789abcdef";
+    string hex;
+    hex.reserve(2 * length);
+    for (size_t i = 0; i < length; i++)
+    {
+        hex.push_back(DIGITS[bytes[i] >> 4]);
+        hex.push_back(DIGITS[bytes[i] & 15]);
+    }
+    return hex;
 }
 
-// Function to set console text color
-void setConsoleColor(int color)
+static bool fromHex(const string &hex, vector<unsigned char> &bytes)
 {
-    SetConsoleTextAttribute(hConsole, color);
+    if (hex.size() % 2 != 0)
+        return false;
+    auto digit = [](char c) -> int
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    };
+    bytes.clear();
+    for (size_t i = 0; i < hex.size(); i += 2)
+    {
+        int high = digit(hex[i]), low = digit(hex[i + 1]);
+        if (high < 0 || low < 0)
+            return false;
+        bytes.push_back(static_cast<unsigned char>(high * 16 + low));
+    }
+    return true;
 }
 
-// Function to display the main application title
-void displayAppTitle()
+// Equal-length comparison that does not stop at the first difference
+static bool constantTimeEquals(const string &a, const string &b)
 {
-    system("cls"); // Clear console screen
-    setConsoleColor(11); // Cyan color
-    cout << "\n\n\t\t*********************************************";
-    cout << "\n\t\t* *";
-    cout << "\n\t\t* WELCOME TO THE BANKING SYSTEM       *"; // Generic title
-    cout << "\n\t\t* *";
-    cout << "\n\t\t*********************************************\n\n";
-    setConsoleColor(7); // White color
+    unsigned char difference = a.size() == b.size() ? 0 : 1;
+    for (size_t i = 0; i < min(a.size(), b.size()); i++)
+        difference |= static_cast<unsigned char>(a[i] ^ b[i]);
+    return difference == 0;
 }
 
-// Function to display loading animation
-void showLoadingScreen()
+// Hash a password for storage with a new random salt
+string hashPassword(const string &password, unsigned iterations = passwordIterations)
 {
-    system("cls");
-    setConsoleColor(10); // Green color
-    cout << "\n\n\n\n\n\t\t\tLoading";
-    for (int i = 0; i < 6; i++)
+    static mutex salt_lock;
+    static random_device entropy;
+    unsigned char salt[16];
     {
-        fordelay(200); // Shorter delay for quicker load
-        cout << ".";
+        lock_guard<mutex> lock(salt_lock);
+        for (int i = 0; i < 16; i += 4)
+        {
+            unsigned int word = entropy();
+            memcpy(salt + i, &word, 4);
+        }
     }
-    system("cls");
+    unsigned char hash[32];
+    pbkdf2Sha256(password, salt, sizeof(salt), iterations, hash);
+    return PASSWORD_HASH_PREFIX + to_string(iterations) + "$" + toHex(salt, sizeof(salt)) + "$" + toHex(hash, sizeof(hash));
 }
 
-// Function to display important instructions to the user
-void showInstructions()
+// Iteration count of a stored hash, 0 for a plaintext entry (or a malformed hash)
+static unsigned storedPasswordIterations(const string &stored, string &salt_hex, string &hash_hex)
 {
-    displayAppTitle();
-    setConsoleColor(14); // Yellow color
-    cout << "\n\t\tIMPORTANT INSTRUCTIONS:\n";
-    setConsoleColor(7); // White color
-    cout << "\n\t1. Keep your account number and password confidential.";
-    cout << "\n\t2. Do not share your OTP or password with anyone.";
-    cout << "\n\t3. Always log out after completing your transactions.";
-    cout << "\n\t4. Report any suspicious activity to the bank immediately.";
-    cout << "\n\t5. Regularly update your password for security.";
-    cout << "\n\n\tPress any key to continue...";
-    _getch(); // Wait for user input
+    if (stored.compare(0, PASSWORD_HASH_PREFIX.size(), PASSWORD_HASH_PREFIX) != 0)
+        return 0;
+    size_t cost_end = stored.find('$', PASSWORD_HASH_PREFIX.size());
+    size_t salt_end = cost_end == string::npos ? string::npos : stored.find('$', cost_end + 1);
+    if (salt_end == string::npos)
+        return 0;
+    salt_hex = stored.substr(cost_end + 1, salt_end - cost_end - 1);
+    hash_hex = stored.substr(salt_end + 1);
+    return static_cast<unsigned>(strtoul(stored.c_str() + PASSWORD_HASH_PREFIX.size(), nullptr, 10));
 }
 
-// Function to display the login page options
-void showLoginPage()
+// Check a password against its stored form (a hash, or plaintext from before hashing)
+bool verifyPassword(const string &stored, const string &password)
 {
-    displayAppTitle();
-    setConsoleColor(14); // Yellow color
-    cout << "\n\t\tLOGIN PAGE\n";
-    setConsoleColor(7); // White color
-    cout << "\n\t1. Employee Login";
-    cout << "\n\t2. Customer Login";
-    cout << "\n\t3. New Customer Registration";
-    cout << "\n\t4. Return to Main Menu";
-    cout << "\n\t5. Exit";
-    cout << "\n\n\tEnter your choice: ";
+    string salt_hex, hash_hex;
+    unsigned iterations = storedPasswordIterations(stored, salt_hex, hash_hex);
+    if (iterations == 0)
+        return stored.compare(0, PASSWORD_HASH_PREFIX.size(), PASSWORD_HASH_PREFIX) != 0 && constantTimeEquals(stored, password);
+    vector<unsigned char> salt;
+    if (!fromHex(salt_hex, salt))
+        return false;
+    unsigned char hash[32];
+    pbkdf2Sha256(password, salt.data(), salt.size(), iterations, hash);
+    return constantTimeEquals(toHex(hash, sizeof(hash)), hash_hex);
 }
 
-// Function to display the signup page title
-void showSignupPage()
+// Outcome of a login's password check: whether it matched, and the hash to store instead when the
+// stored form is plaintext or uses another cost (empty when it is current)
+struct PasswordCheck
 {
-    displayAppTitle();
-    setConsoleColor(14); // Yellow color
-    cout << "\n\t\tNEW CUSTOMER REGISTRATION\n";
-    setConsoleColor(7); // White color
+    bool valid = false;
+    string rehashed;
+};
+
+PasswordCheck checkPassword(const string &stored, const string &password)
+{
+    PasswordCheck check;
+    check.valid = verifyPassword(stored, password);
+    string salt_hex, hash_hex;
+    if (check.valid && storedPasswordIterations(stored, salt_hex, hash_hex) != passwordIterations)
+        check.rehashed = hashPassword(password);
+    return check;
 }
 
-// Function to get password input securely (masked with asterisks)
-string getSecurePasswordInput()
+// Stored form to check unknown IDs against, so they cost as much as a wrong password. It is rebuilt
+// when the hashing cost changes, so it always costs what a current account's hash does.
+string unknownUserPasswordHash()
 {
-    string password;
-    char ch;
-    while (true)
+    static mutex lock;
+    static string hash;
+    static unsigned iterations = 0;
+    lock_guard<mutex> guard(lock);
+    if (iterations != passwordIterations)
     {
-        ch = _getch(); // Get character without echoing to console
-        if (ch == 13) // Enter key
-            break;
-        else if (ch == 8) // Backspace key
-        {
-            if (!password.empty())
-            {
-                cout << "\b \b"; // Erase character from console
-                password.pop_back();
-            }
-        }
-        else if (isprint(ch)) // Check if printable character
-        {
-            password.push_back(ch);
-            cout << '*'; // Display asterisk
-        }
+        iterations = passwordIterations;
+        hash = hashPassword("", iterations);
     }
-    cout << endl; // New line after password input
-    return password;
+    return hash;
 }
 
-// Helper function to get current date and time as a string
-string getCurrentDateTime()
+// Bounded worker pool for password checks and hashing, so a slow hash never runs on a server event
+// loop thread or under the bank lock. Jobs are refused rather than queued without limit when the
+// pool falls behind. Workers start on first use, in each process (a forked replica starts its own),
+// and live until exit.
+class PasswordWorkers
 {
-    time_t now = time(0);
-    string dt = ctime(&now);
-    // ctime adds a newline, remove it
-    dt.erase(remove(dt.begin(), dt.end(), '\n'), dt.end());
-    return dt;
-}
+public:
+    static const size_t MAX_QUEUED = 4096;
 
-// Load all credentials from CSV files into maps
-void loadAllCredentials()
-{
-    // Load account credentials from Account_info.csv
-    ifstream accFile("Account_info.csv");
-    if (accFile.is_open())
+    // Queue a job; false when MAX_QUEUED jobs are already waiting (the caller should shed the request)
+    bool trySubmit(function<void()> job)
     {
-        string line;
-        while (getline(accFile, line))
+        Pool &current = pool();
         {
-            size_t pos = line.find(',');
-            if (pos != string::npos)
-            {
-                string acc_no = line.substr(0, pos);
-                string pass = line.substr(pos + 1);
-                accountCredentials[acc_no] = pass;
-            }
+            lock_guard<mutex> lock(current.lock);
+            if (current.jobs.size() >= MAX_QUEUED)
+                return false;
+            current.jobs.push_back(move(job));
         }
-        accFile.close();
+        current.ready.notify_one();
+        return true;
     }
-    // If file doesn't exist, accountCredentials map remains empty, which is fine
 
-    // Load employee credentials from Employee_info.csv
-    ifstream empFile("Employee_info.csv");
-    if (empFile.is_open())
+    size_t threadCount() { return pool().threads; }
+
+private:
+    struct Pool
     {
-        string line;
-        while (getline(empFile, line))
+        mutex lock;
+        condition_variable ready;
+        deque<function<void()>> jobs;
+        size_t threads = 0;
+#ifndef _WIN32
+        pid_t owner = getpid();
+#endif
+    };
+
+    Pool &pool()
+    {
+        lock_guard<mutex> lock(start_lock);
+#ifdef _WIN32
+        bool stale = false;
+#else
+        bool stale = current != nullptr && current->owner != getpid(); // Forked: the workers stayed behind
+#endif
+        if (current == nullptr || stale)
         {
-            size_t pos = line.find(',');
-            if (pos != string::npos)
-            {
-                string emp_id = line.substr(0, pos);
-                string pass = line.substr(pos + 1);
-                employeeCredentials[emp_id] = pass;
-            }
+            current = new Pool(); // Never freed: detached workers may still be waiting on it at exit
+            current->threads = max(1u, thread::hardware_concurrency());
+            for (size_t i = 0; i < current->threads; i++)
+                thread(work, current).detach();
         }
-        empFile.close();
+        return *current;
     }
-    else
+
+    static void work(Pool *pool)
     {
-        // Create a default admin if Employee_info.csv does not exist
-        employeeCredentials["admin"] = "admin123";
-        saveAllCredentials(); // Save this default admin to the file
+        while (true)
+        {
+            function<void()> job;
+            {
+                unique_lock<mutex> lock(pool->lock);
+                pool->ready.wait(lock, [pool]() { return !pool->jobs.empty(); });
+                job = move(pool->jobs.front());
+                pool->jobs.pop_front();
+            }
+            job();
+        }
     }
-}
 
-// Save all credentials from maps to CSV files
-void saveAllCredentials()
+    mutex start_lock;
+    Pool *current = nullptr;
+};
+
+PasswordWorkers passwordWorkers;
+
+// Session tokens handed out by a server-mode LOGIN: another connection presenting the token is
+// logged in as the same account without checking the password again. Tokens are 128 random bits
+// and expire in time buckets like IdempotencyTable (14-15 minutes after issue); the table holds at
+// most MAX_TOKENS, expiring its oldest bucket early when full.
+class SessionTokens
 {
-    // Save employee credentials to Employee_info.csv
-    ofstream empFile("Employee_info.csv");
-    if (empFile.is_open())
+public:
+    static const int TTL_BUCKETS = 15;
+    static const time_t BUCKET_SECONDS = 60;
+    static const size_t MAX_TOKENS = 1 << 20;
+
+    string issue(const string &acc_no, time_t now)
     {
-        for (const auto &pair : employeeCredentials)
+        advance(now);
+        if (entries.size() >= MAX_TOKENS)
         {
-            empFile << pair.first << "," << pair.second << "\n";
+            expireBucket(oldest_bucket);
+            if (oldest_bucket < current_bucket)
+                oldest_bucket++;
         }
-        empFile.close();
+        unsigned char bits[16];
+        for (int i = 0; i < 16; i += 4)
+        {
+            unsigned int word = entropy();
+            memcpy(bits + i, &word, 4);
+        }
+        string token = toHex(bits, sizeof(bits));
+        unsigned long long key;
+        memcpy(&key, bits, sizeof(key));
+        entries[key] = Entry{token, acc_no, current_bucket};
+        buckets[current_bucket % TTL_BUCKETS].push_back(key);
+        return token;
     }
-    else
+
+    // Account the token was issued to, nullptr if it is unknown or has expired
+    const string *find(const string &token, time_t now)
     {
-        setConsoleColor(12);
-        cout << "\n\tError: Could not open Employee_info.csv for saving credentials.";
-        setConsoleColor(7);
+        advance(now);
+        vector<unsigned char> bits;
+        if (token.size() != 32 || !fromHex(token, bits))
+            return nullptr;
+        unsigned long long key;
+        memcpy(&key, bits.data(), sizeof(key));
+        auto found = entries.find(key);
+        if (found == entries.end() || !constantTimeEquals(found->second.token, token))
+            return nullptr;
+        return &found->second.account;
     }
 
-    // Save account credentials to Account_info.csv
-    ofstream accFile("Account_info.csv");
-    if (accFile.is_open())
+    size_t size() const { return entries.size(); }
+
+private:
+    struct Entry
     {
-        for (const auto &pair : accountCredentials)
+        string token;
+        string account;
+        long long bucket;
+    };
+
+    void expireBucket(long long bucket)
+    {
+        vector<unsigned long long> &keys = buckets[bucket % TTL_BUCKETS];
+        for (unsigned long long key : keys)
         {
-            accFile << pair.first << "," << pair.second << "\n";
+            auto found = entries.find(key);
+            if (found != entries.end() && found->second.bucket == bucket)
+                entries.erase(found);
         }
-        accFile.close();
+        keys.clear();
     }
-    else
+
+    void advance(time_t now)
     {
-        setConsoleColor(12);
-        cout << "\n\tError: Could not open Account_info.csv for saving credentials.";
-        setConsoleColor(7);
+        long long bucket = static_cast<long long>(now / BUCKET_SECONDS);
+        if (current_bucket < 0 || bucket - current_bucket >= TTL_BUCKETS)
+        {
+            entries.clear();
+            for (auto &keys : buckets)
+                keys.clear();
+            current_bucket = oldest_bucket = bucket;
+            return;
+        }
+        while (current_bucket < bucket)
+        {
+            current_bucket++;
+            for (; oldest_bucket <= current_bucket - TTL_BUCKETS; oldest_bucket++)
+                expireBucket(oldest_bucket);
+        }
     }
-}
 
+    unordered_map<unsigned long long, Entry> entries; // Keyed by the token's first 64 bits
+    array<vector<unsigned long long>, TTL_BUCKETS> buckets;
+    long long current_bucket = -1, oldest_bucket = -1;
+    random_device entropy;
+};
 
-// --- Bank Class Member Functions Implementation ---
-
-// Function to create a new customer account
-void Bank::createNewAccount()
+// Customer service desk for many employees. Every employee on duty owns a ticket queue with its
+// own lock; a new ticket goes to the shortest queue among the employees who specialise in its
+// type, else among the generalists, else among everyone on duty (with nobody on duty it waits in
+// the intake queue). An employee whose queue runs dry takes from the intake and then steals the
+// newest ticket of the longest queue, so the owner and the thief work opposite ends. Wait time
+// (filed to taken) and handle time (taken to resolved) are sampled per desk for percentiles. Filing
+// and taking lock only the queues they touch; nothing is shared by every operation.
+const int SERVICE_TYPES = 4; // serviceTypeName choices 1..4
+struct ServiceTicket
 {
-    string account_number, name, dob, age, address, phone, deposit_amount_str, acc_type, password;
-    int choice_int;
-    bool accountExists;
-
-    do {
-        displayAppTitle();
-        cout << "\n\t\tACCOUNT CREATION\n";
-        cout << "\n\tEnter Account Number: ";
-        cin >> account_number;
+    unsigned long long id = 0;
+    int type = 0; // serviceTypeName choice
+    string text;  // "<filed at> | Account: ... | Type: ... | Desc: ..."
+    chrono::steady_clock::time_point submitted, taken;
+};
+struct ServicePercentiles
+{
+    size_t count = 0;
+    long long p50 = 0, p90 = 0, p99 = 0; // Microseconds
+};
+class ServiceDesk
+{
+public:
+    static const int MAX_DESKS = 1024;
+    static const size_t MAX_SAMPLES = 4096; // Latest samples kept per desk and ticket type
 
-        accountExists = (accountCredentials.find(account_number) != accountCredentials.end());
+    ServiceDesk()
+    {
+        intake.employee = "(intake)";
+        intake.on_duty = false;
+    }
 
-        if (accountExists)
+    // Employee comes on duty (again). Returns the employee's desk number, -1 when all desks are taken.
+    // Desks are never removed, so desk numbers stay valid and the desk table is read without a lock.
+    int openDesk(const string &employee)
+    {
+        lock_guard<mutex> guard(registry_lock);
+        auto found = by_employee.find(employee);
+        if (found != by_employee.end())
         {
-            setConsoleColor(12);
-            cout << "\n\tAccount No. " << account_number << " already exists!";
-            setConsoleColor(7);
-            cout << "\n\t1. Try a different Account Number\n\t2. Login To Existing Account\n\tChoice: ";
-            cin >> choice_int;
-            if (choice_int == 2) {
-                customerLogin(); // Go to customer login
-                return; // Exit this function
-            }
+            desks[found->second]->on_duty = true;
+            return found->second;
         }
-    } while (accountExists && choice_int == 1); // Loop if account exists and user wants to try again
-
-    // Clear input buffer after reading account number
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-
-    cout << "\n\tEnter Name: ";
-    getline(cin, name);
+        int number = desk_count.load(memory_order_relaxed);
+        if (number == MAX_DESKS)
+            return -1;
+        owned.emplace_back(new Desk());
+        owned.back()->employee = employee;
+        desks[number] = owned.back().get();
+        by_employee.emplace(employee, number);
+        desk_count.store(number + 1, memory_order_release);
+        return number;
+    }
 
-    cout << "\n\tEnter Date of Birth (DD/MM/YYYY): "; // Changed format for clarity
-    getline(cin, dob); // Use getline for full date string
+    // Desk number of an employee, -1 if the employee never came on duty
+    int deskOf(const string &employee)
+    {
+        lock_guard<mutex> guard(registry_lock);
+        auto found = by_employee.find(employee);
+        return found == by_employee.end() ? -1 : found->second;
+    }
 
-    cout << "\n\tEnter Age: ";
-    cin >> age;
-    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Clear buffer
+    // Employee goes off duty: no new tickets, and colleagues steal what is left on the queue
+    void closeDesk(int desk)
+    {
+        if (valid(desk))
+            desks[desk]->on_duty = false;
+    }
 
-    cout << "\n\tEnter Address (single line): ";
-    getline(cin, address);
+    // Ticket type routed to this desk first; 0 takes every type
+    void setSpecialty(int desk, int type)
+    {
+        if (valid(desk))
+            desks[desk]->specialty = type;
+    }
 
-    cout << "\n\tEnter Phone Number: ";
-    cin >> phone;
+    int specialty(int desk) { return valid(desk) ? desks[desk]->specialty.load() : 0; }
 
-    cout << "\n\tWould you like to make an initial deposit?\n\t1. Yes\n\t2. No\n\tChoice: ";
-    cin >> choice_int;
-    if (choice_int == 1)
+    // File a ticket. Returns its position in the queue it joined; 'assigned_to' names the queue's
+    // employee (empty for the intake).
+    size_t submit(int type, const string &text, string &assigned_to)
     {
-        float depo_val;
-        cout << "\n\tEnter the amount to deposit: Rs ";
-        while (!(cin >> depo_val) || depo_val < 0) {
-            setConsoleColor(12);
-            cout << "\n\tInvalid amount. Please enter a non-negative number: Rs ";
-            setConsoleColor(7);
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        ServiceTicket ticket;
+        ticket.id = next_id.fetch_add(1, memory_order_relaxed);
+        ticket.type = type < 1 || type > SERVICE_TYPES ? SERVICE_TYPES : type; // Unknown types are "Other"
+        ticket.text = text;
+        ticket.submitted = chrono::steady_clock::now();
+
+        Desk *best[3] = {nullptr, nullptr, nullptr}; // Specialist, generalist, anyone
+        int count = desk_count.load(memory_order_acquire);
+        for (int i = 0; i < count; i++)
+        {
+            Desk *desk = desks[i];
+            if (!desk->on_duty)
+                continue;
+            int specialty = desk->specialty;
+            int rank = specialty == ticket.type ? 0 : specialty == 0 ? 1 : 2;
+            if (best[rank] == nullptr || desk->size < best[rank]->size)
+                best[rank] = desk;
         }
-        deposit_amount_str = to_string(depo_val);
-    }
-    else
-    {
-        deposit_amount_str = "0.0"; // Initialize with 0.0 for consistency
+        Desk *target = best[0] ? best[0] : best[1] ? best[1] : best[2] ? best[2] : &intake;
+        assigned_to = target == &intake ? "" : target->employee;
+        lock_guard<mutex> desk_guard(target->lock);
+        target->tickets.push_back(move(ticket));
+        return ++target->size;
     }
 
-    cout << "\n\tSelect Type of Account:\n\t1. Saving\n\t2. Current\n\tChoice: ";
-    cin >> choice_int;
-    acc_type = (choice_int == 1) ? "Saving" : "Current";
+    // Next ticket for a desk: its own queue, then the intake, then stolen. 'taken_from' names the
+    // queue it came from when that is not the desk's own. Returns false when all queues are empty.
+    bool take(int desk, ServiceTicket &ticket, string &taken_from)
+    {
+        Desk *own = valid(desk) ? desks[desk] : nullptr;
+        taken_from.clear();
+        if (own != nullptr && popFront(*own, ticket))
+            return true;
+        if (popFront(intake, ticket))
+        {
+            taken_from = intake.employee;
+            return true;
+        }
+        // Steal from the longest queue; sizes are only a hint, so retry if it emptied meanwhile
+        for (;;)
+        {
+            Desk *victim = nullptr;
+            int count = desk_count.load(memory_order_acquire);
+            for (int i = 0; i < count; i++)
+            {
+                if (desks[i] != own && desks[i]->size > 0 && (victim == nullptr || desks[i]->size > victim->size))
+                    victim = desks[i];
+            }
+            if (victim == nullptr)
+                return false;
+            lock_guard<mutex> desk_guard(victim->lock);
+            if (victim->tickets.empty())
+                continue;
+            ticket = move(victim->tickets.back());
+            victim->tickets.pop_back();
+            victim->size--;
+            ticket.taken = chrono::steady_clock::now();
+            if (own != nullptr)
+                own->stolen++;
+            taken_from = victim->employee;
+            return true;
+        }
+    }
+
+    // The desk resolved a ticket returned by take()
+    void complete(int desk, const ServiceTicket &ticket)
+    {
+        Desk &owner = valid(desk) ? *desks[desk] : intake;
+        long long wait_us = chrono::duration_cast<chrono::microseconds>(ticket.taken - ticket.submitted).count();
+        long long handle_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - ticket.taken).count();
+        lock_guard<mutex> metrics_guard(owner.metrics_lock);
+        owner.handled++;
+        Samples &samples = owner.samples[ticket.type - 1];
+        size_t slot = samples.recorded++ % MAX_SAMPLES;
+        if (samples.wait_us.size() < MAX_SAMPLES)
+        {
+            samples.wait_us.push_back(wait_us);
+            samples.handle_us.push_back(handle_us);
+        }
+        else
+        {
+            samples.wait_us[slot] = wait_us;
+            samples.handle_us[slot] = handle_us;
+        }
+    }
+
+    // Tickets waiting on every queue (a moment's sum, not a snapshot)
+    size_t pending()
+    {
+        size_t total = intake.size;
+        int count = desk_count.load(memory_order_acquire);
+        for (int i = 0; i < count; i++)
+            total += desks[i]->size;
+        return total;
+    }
+
+    size_t pending(int desk) { return valid(desk) ? desks[desk]->size.load() : 0; }
+
+    // Oldest ticket on the desk's queue (or the intake when that is empty), empty if none
+    string peek(int desk)
+    {
+        for (Desk *queue : {valid(desk) ? desks[desk] : nullptr, &intake})
+        {
+            if (queue == nullptr)
+                continue;
+            lock_guard<mutex> desk_guard(queue->lock);
+            if (!queue->tickets.empty())
+                return queue->tickets.front().text;
+        }
+        return "";
+    }
+
+    struct DeskStatus
+    {
+        string employee;
+        bool on_duty;
+        int specialty;
+        size_t handled, stolen;
+        vector<string> tickets; // Queue order
+    };
+
+    // Every queue (intake first) with its tickets, for listings
+    vector<DeskStatus> status()
+    {
+        vector<DeskStatus> result;
+        for (Desk *desk : allDesks())
+        {
+            DeskStatus row{desk->employee, desk->on_duty, desk->specialty, desk->handled, desk->stolen, {}};
+            lock_guard<mutex> desk_guard(desk->lock);
+            for (const ServiceTicket &ticket : desk->tickets)
+                row.tickets.push_back(ticket.text);
+            result.push_back(move(row));
+        }
+        return result;
+    }
+
+    // Wait and handle time percentiles over the sampled tickets of one type (1..SERVICE_TYPES, 0 = all)
+    void percentiles(int type, ServicePercentiles &wait, ServicePercentiles &handle)
+    {
+        vector<long long> waits, handles;
+        for (Desk *desk : allDesks())
+        {
+            lock_guard<mutex> metrics_guard(desk->metrics_lock);
+            for (int t = 0; t < SERVICE_TYPES; t++)
+            {
+                if (type != 0 && t != type - 1)
+                    continue;
+                waits.insert(waits.end(), desk->samples[t].wait_us.begin(), desk->samples[t].wait_us.end());
+                handles.insert(handles.end(), desk->samples[t].handle_us.begin(), desk->samples[t].handle_us.end());
+            }
+        }
+        wait = summarize(waits);
+        handle = summarize(handles);
+    }
+
+private:
+    struct Samples
+    {
+        size_t recorded = 0;
+        vector<long long> wait_us, handle_us; // Ring of the latest MAX_SAMPLES
+    };
+    // One employee's queue. Each desk sits on its own cache lines so desks never share a line.
+    struct alignas(64) Desk
+    {
+        string employee; // Fixed once the desk is published
+        atomic<bool> on_duty{true};
+        atomic<int> specialty{0};
+        atomic<size_t> size{0}; // Mirrors tickets.size(); read without the lock for routing
+        mutex lock;             // Guards tickets
+        deque<ServiceTicket> tickets;
+        atomic<size_t> handled{0}, stolen{0};
+        mutex metrics_lock; // Guards samples
+        array<Samples, SERVICE_TYPES> samples;
+    };
+
+    bool valid(int desk) const { return desk >= 0 && desk < desk_count.load(memory_order_acquire); }
+
+    bool popFront(Desk &desk, ServiceTicket &ticket)
+    {
+        if (desk.size == 0)
+            return false;
+        lock_guard<mutex> desk_guard(desk.lock);
+        if (desk.tickets.empty())
+            return false;
+        ticket = move(desk.tickets.front());
+        desk.tickets.pop_front();
+        desk.size--;
+        ticket.taken = chrono::steady_clock::now();
+        return true;
+    }
+
+    vector<Desk *> allDesks()
+    {
+        vector<Desk *> result{&intake};
+        int count = desk_count.load(memory_order_acquire);
+        for (int i = 0; i < count; i++)
+            result.push_back(desks[i]);
+        return result;
+    }
+
+    static ServicePercentiles summarize(vector<long long> &samples)
+    {
+        ServicePercentiles result;
+        result.count = samples.size();
+        if (samples.empty())
+            return result;
+        sort(samples.begin(), samples.end());
+        auto at = [&samples](double p) { return samples[min(samples.size() - 1, static_cast<size_t>(p * samples.size()))]; };
+        result.p50 = at(0.50);
+        result.p90 = at(0.90);
+        result.p99 = at(0.99);
+        return result;
+    }
+
+    array<Desk *, MAX_DESKS> desks{}; // Slots below desk_count are published and never change
+    atomic<int> desk_count{0};
+    mutex registry_lock; // Guards owned and by_employee (opening desks, name lookups)
+    vector<unique_ptr<Desk>> owned;
+    unordered_map<string, int> by_employee;
+    Desk intake; // Tickets filed while nobody is on duty
+    atomic<unsigned long long> next_id{1};
+};
+ServiceDesk serviceDesk; // Customer service tickets, shared by every Bank instance
+string currentEmployee;  // Employee logged in at this console, empty otherwise
+
+// Interest posting settings (persisted to Interest_config.csv)
+struct InterestConfig
+{
+    long long annual_rate_bp = 350; // Annual rate for Saving accounts in basis points (350 = 3.50%)
+    int postings_per_year = 12;     // How often interest is credited
+    time_t last_run = 0;            // Run id (timestamp) of the last committed posting
+};
+
+// Analytics results for the admin dashboard
+const int BALANCE_BUCKETS = 6;  // <1K, <10K, <100K, <1M, <10M, >=10M (Rs)
+const int AGE_COHORTS = 5;      // <30 days, <6 months, <1 year, <3 years, >=3 years
+struct AccountTypeStats
+{
+    size_t count = 0;
+    long long total = 0;
+    long long min_balance = numeric_limits<long long>::max();
+    long long max_balance = numeric_limits<long long>::min();
+};
+struct DailyVolume
+{
+    size_t count = 0;
+    long long total = 0;
+};
+struct AnalyticsReport
+{
+    size_t accounts = 0;
+    long long total_deposits = 0;
+    array<size_t, BALANCE_BUCKETS> balance_histogram{};
+    array<size_t, AGE_COHORTS> age_cohorts{};
+    map<string, AccountTypeStats> by_type;
+    map<long long, DailyVolume> daily_volume; // Keyed by day number since epoch (UTC)
+};
+
+// Forward declarations
+void fordelay(int);
+int readKey();
+void close_application(void);
+int main();
+void showEmployeeMenu();
+void employeeLogin();
+void customerLogin();
+void showCustomerMenu();
+void displayAppTitle();
+void showLoginPage();
+void showSignupPage();
+void showInstructions();
+void showLoadingScreen();
+void setConsoleColor(int color);
+bool loadCredentialFile(const string &filename, map<string, string> &credentials);
+void loadAllCredentials();
+void saveAllCredentials();
+string getSecurePasswordInput();
+string getCurrentDateTime(); // Helper to get current date/time
+string formatDateTime(time_t when);
+vector<string> splitCsvLine(const string &line);
+const char *accountFieldError(const string &value);
+string readAccountField(const char *prompt);
+bool saveTransactionLedger();
+void runReplicationDrill();
+long long parseAmountToPaise(const string &amount);
+string formatPaise(long long paise);
+long long daysFromCivil(long long y, unsigned m, unsigned d);
+long long parseDateToDays(const string &date_time);
+void publishLedgerEntry(const LedgerEntry &entry);
+void recordTransaction(const string &kind, const string &account, const string &counterparty, long long amount);
+void loadTransactionLedger();
+void appendLedgerEntries(const vector<LedgerEntry> &entries, ostream &out);
+bool replaceFile(const string &from, const string &to);
+bool archiveLedgerBefore(time_t cutoff, size_t &archived, size_t &archive_bytes, size_t &text_bytes);
+InterestConfig loadInterestConfig();
+bool saveInterestConfig(const InterestConfig &config);
+void recoverInterestRun();
+VelocityRules loadVelocityRules();
+bool saveVelocityRules(const VelocityRules &rules);
+void manageVelocityRules();
+const char *txnStatusMessage(TxnStatus status);
+string serviceTypeName(int service_choice);
+void runLoadTestClient();
+void runServiceDeskBenchmark();
+void showServerMenu();
+void manageShardedBook();
+void runShardBenchmark(bool sync_journals);
+void runHotAccountBenchmark();
+size_t parallelWorkerCount(size_t items);
+void recoverStandingOrderRun();
+void runTimingWheelBenchmark();
+unsigned loadPasswordCost();
+bool savePasswordCost(unsigned iterations);
+void manageLoginSecurity();
+void runLoginBenchmark();
+
+// Standing orders: scheduled and recurring transfers. The book is journaled to Standing_orders.csv,
+// one record per change, and compacted when it is loaded:
+//   A,<id>,<from>,<to>,<amount paise>,<due>,<period s>[,<last status>]  order added (period 0 = once)
+//   F,<id>,<next due>,<status>                          ran, next run at <next due>
+//   D,<id>,<status>                                     ran for the last time
+//   C,<id>                                              cancelled
+// Pending orders sit on a hierarchical timing wheel of LEVELS x 256 one-second slots (spans of
+// 256 s, 18 h, 194 days and 136 years). An order is linked into the level whose span covers its
+// delay and moves down a level when the level below wraps, so insert and cancel are O(1) list
+// operations on pooled nodes and advancing the clock only visits slots as they come due.
+struct StandingOrder
+{
+    unsigned long long id = 0; // 0 marks a free pool slot
+    string from, to;
+    long long amount = 0; // Paise
+    long long due = 0;    // Next run (epoch seconds)
+    long long period = 0; // Seconds between runs, 0 = once
+    int last_status = -1; // TxnStatus of the last run, -1 before the first
+    uint32_t prev = 0, next = 0, bucket = 0; // Wheel links (pool indexes)
+};
+class StandingOrderBook
+{
+public:
+    static const int LEVELS = 4, SLOT_BITS = 8, SLOTS = 1 << SLOT_BITS;
+    static constexpr uint32_t NONE = numeric_limits<uint32_t>::max();
+    static const uint32_t READY = LEVELS * SLOTS; // Bucket of orders already due
+
+    StandingOrderBook() { heads.fill(NONE); }
+
+    // Empty book with its clock at 'now'; an empty journal keeps the book in memory only
+    void reset(long long now, const string &journal)
+    {
+        orders.clear();
+        free_slots.clear();
+        by_id.clear();
+        heads.fill(NONE);
+        clock = now;
+        next_id = 1;
+        journal_path = journal;
+    }
+
+    // Replay the journal, then rewrite it with one A record per live order. Returns false if the
+    // compacted journal could not be written (the old one is kept).
+    bool load(const string &journal, long long now)
+    {
+        reset(now, "");
+        ifstream file(journal);
+        string line;
+        while (file.is_open() && getline(file, line))
+        {
+            vector<string> fields = splitCsvLine(line);
+            if (fields.size() < 2 || fields[0].size() != 1)
+                continue;
+            unsigned long long id = strtoull(fields[1].c_str(), nullptr, 10);
+            next_id = max(next_id, id + 1);
+            auto found = by_id.find(id);
+            if (fields[0] == "A" && fields.size() >= 7 && found == by_id.end())
+            {
+                uint32_t index = insertOrder(id, fields[2], fields[3], atoll(fields[4].c_str()), atoll(fields[5].c_str()), atoll(fields[6].c_str()));
+                if (fields.size() >= 8)
+                    orders[index].last_status = atoi(fields[7].c_str());
+            }
+            else if (found == by_id.end())
+                continue;
+            else if (fields[0] == "F" && fields.size() >= 4)
+            {
+                StandingOrder &order = orders[found->second];
+                unlink(found->second);
+                order.due = atoll(fields[2].c_str());
+                order.last_status = atoi(fields[3].c_str());
+                link(found->second);
+            }
+            else if (fields[0] == "D" || fields[0] == "C")
+                release(found->second);
+        }
+        file.close();
+
+        journal_path = journal;
+        string compacted;
+        for (const StandingOrder &order : orders)
+        {
+            if (order.id != 0)
+                compacted += addRecord(order);
+        }
+        ofstream out(journal + ".tmp", ios::binary);
+        out << compacted;
+        out.close();
+        return !out.fail() && replaceFile(journal + ".tmp", journal);
+    }
+
+    // New order; returns its id, or 0 if the journal could not be written
+    unsigned long long add(const string &from, const string &to, long long amount, long long due, long long period)
+    {
+        uint32_t index = insertOrder(next_id, from, to, amount, due, period);
+        if (!appendJournal(addRecord(orders[index])))
+        {
+            release(index);
+            return 0;
+        }
+        return next_id++;
+    }
+
+    bool cancel(unsigned long long id)
+    {
+        auto found = by_id.find(id);
+        if (found == by_id.end() || !appendJournal("C," + to_string(id) + "\n"))
+            return false;
+        release(found->second);
+        return true;
+    }
+
+    // Advance the clock to 'now' and unlink every order due by then (pool indexes into 'due')
+    void collectDue(long long now, vector<uint32_t> &due)
+    {
+        drain(READY, due);
+        if (by_id.empty())
+            clock = max(clock, now);
+        while (clock < now)
+        {
+            clock++;
+            for (int level = LEVELS - 1; level > 0; level--)
+            {
+                if ((clock & ((1LL << (SLOT_BITS * level)) - 1)) != 0)
+                    continue;
+                uint32_t bucket = level * SLOTS + static_cast<uint32_t>((clock >> (SLOT_BITS * level)) & (SLOTS - 1));
+                uint32_t index = heads[bucket];
+                heads[bucket] = NONE;
+                while (index != NONE)
+                {
+                    uint32_t next = orders[index].next;
+                    link(index); // Lands in a lower level (or READY if due this second)
+                    index = next;
+                }
+            }
+            drain(static_cast<uint32_t>(clock & (SLOTS - 1)), due);
+            drain(READY, due);
+        }
+    }
+
+    // Journal records for the outcome of collected orders, without applying them
+    string runRecords(const vector<uint32_t> &ran, const vector<int> &statuses, long long now) const
+    {
+        string records;
+        for (size_t i = 0; i < ran.size(); i++)
+        {
+            const StandingOrder &order = orders[ran[i]];
+            if (order.period > 0)
+                records += "F," + to_string(order.id) + "," + to_string(nextRun(order, now)) + "," + to_string(statuses[i]) + "\n";
+            else
+                records += "D," + to_string(order.id) + "," + to_string(statuses[i]) + "\n";
+        }
+        return records;
+    }
+
+    // Apply the outcome once runRecords() is durable: recurring orders move to their next run
+    // (runs missed while the application was closed are made once, not repeated), others are freed
+    void finishRun(const vector<uint32_t> &ran, const vector<int> &statuses, long long now)
+    {
+        for (size_t i = 0; i < ran.size(); i++)
+        {
+            StandingOrder &order = orders[ran[i]];
+            if (order.period > 0)
+            {
+                order.due = nextRun(order, now);
+                order.last_status = statuses[i];
+                link(ran[i]);
+            }
+            else
+                release(ran[i]);
+        }
+    }
+
+    // Put collected orders back unchanged (their run was rolled back)
+    void requeue(const vector<uint32_t> &ran)
+    {
+        for (uint32_t index : ran)
+            link(index);
+    }
+
+    bool appendJournal(const string &records)
+    {
+        if (journal_path.empty() || records.empty())
+            return true;
+        ofstream file(journal_path, ios::app | ios::binary);
+        file << records;
+        file.close();
+        return !file.fail();
+    }
+
+    const StandingOrder &order(uint32_t index) const { return orders[index]; }
+    size_t size() const { return by_id.size(); }
+    size_t memoryBytes() const { return orders.capacity() * sizeof(StandingOrder) + by_id.size() * 32 + sizeof(heads); }
+    const string &journal() const { return journal_path; }
+
+    // Orders paid from one account, by id
+    vector<const StandingOrder *> ordersFrom(const string &acc_no) const
+    {
+        vector<const StandingOrder *> result;
+        for (const StandingOrder &order : orders)
+        {
+            if (order.id != 0 && order.from == acc_no)
+                result.push_back(&order);
+        }
+        sort(result.begin(), result.end(), [](const StandingOrder *a, const StandingOrder *b) { return a->id < b->id; });
+        return result;
+    }
+
+private:
+    static long long nextRun(const StandingOrder &order, long long now)
+    {
+        return order.due <= now ? order.due + ((now - order.due) / order.period + 1) * order.period : order.due + order.period;
+    }
+
+    static string addRecord(const StandingOrder &order)
+    {
+        return "A," + to_string(order.id) + "," + order.from + "," + order.to + "," + to_string(order.amount) + "," +
+               to_string(order.due) + "," + to_string(order.period) + (order.last_status < 0 ? "" : "," + to_string(order.last_status)) + "\n";
+    }
+
+    uint32_t insertOrder(unsigned long long id, const string &from, const string &to, long long amount, long long due, long long period)
+    {
+        uint32_t index;
+        if (!free_slots.empty())
+        {
+            index = free_slots.back();
+            free_slots.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(orders.size());
+            orders.emplace_back();
+        }
+        StandingOrder &order = orders[index];
+        order.id = id;
+        order.from = from;
+        order.to = to;
+        order.amount = amount;
+        order.due = due;
+        order.period = max(0LL, period);
+        order.last_status = -1;
+        by_id[id] = index;
+        link(index);
+        return index;
+    }
+
+    void release(uint32_t index)
+    {
+        StandingOrder &order = orders[index];
+        if (order.bucket != NONE)
+            unlink(index);
+        by_id.erase(order.id);
+        order = StandingOrder();
+        free_slots.push_back(index);
+    }
+
+    void link(uint32_t index)
+    {
+        StandingOrder &order = orders[index];
+        long long delay = order.due - clock;
+        uint32_t bucket = READY;
+        if (delay > 0)
+        {
+            int level = 0;
+            while (level < LEVELS - 1 && delay >= (1LL << (SLOT_BITS * (level + 1))))
+                level++;
+            bucket = level * SLOTS + static_cast<uint32_t>((order.due >> (SLOT_BITS * level)) & (SLOTS - 1));
+        }
+        order.bucket = bucket;
+        order.prev = NONE;
+        order.next = heads[bucket];
+        if (order.next != NONE)
+            orders[order.next].prev = index;
+        heads[bucket] = index;
+    }
+
+    void unlink(uint32_t index)
+    {
+        StandingOrder &order = orders[index];
+        if (order.prev != NONE)
+            orders[order.prev].next = order.next;
+        else
+            heads[order.bucket] = order.next;
+        if (order.next != NONE)
+            orders[order.next].prev = order.prev;
+        order.bucket = NONE;
+    }
+
+    // Move a whole bucket into 'due'
+    void drain(uint32_t bucket, vector<uint32_t> &due)
+    {
+        uint32_t index = heads[bucket];
+        heads[bucket] = NONE;
+        while (index != NONE)
+        {
+            due.push_back(index);
+            orders[index].bucket = NONE;
+            index = orders[index].next;
+        }
+    }
+
+    vector<StandingOrder> orders; // Pool; freed slots are reused
+    vector<uint32_t> free_slots;
+    unordered_map<unsigned long long, uint32_t> by_id;
+    array<uint32_t, LEVELS * SLOTS + 1> heads{}; // List head per bucket (READY last)
+    long long clock = 0;                         // Wheel time: every order due by now has been collected
+    unsigned long long next_id = 1;
+    string journal_path;
+};
+StandingOrderBook standingOrders; // Shared by every Bank instance, like the ledger
+
+// While set, recordTransaction collects ledger entries here instead of appending each one to
+// Transaction_log.csv, so a batch job can write them as part of its own commit
+vector<LedgerEntry> *ledgerBatch = nullptr;
+
+// --- Server session coroutines ---
+// An interactive server session is a coroutine: it suspends on every prompt instead of blocking a
+// thread, so a session costs one heap frame and the event loop threads are shared by all of them.
+
+// Input/output channel between one connection and its session coroutine
+struct SessionIO
+{
+    deque<string> lines;          // Received lines not yet consumed by the session
+    string output;                // Prompts and replies waiting to be sent
+    coroutine_handle<> waiting;   // Suspended coroutine to resume when its wait is over
+    bool awaiting_durable = false; // Suspended until the next save of the account files
+    bool awaiting_offload = false; // Suspended until 'offloaded' has run on the password workers
+    function<void()> offloaded;    // Work handed to the event loop to submit (taken when submitted)
+
+    void write(const string &text) { output += text; }
+
+    // co_await io.readLine() suspends until the client sends a full line
+    struct LineAwaiter
+    {
+        SessionIO &io;
+        bool await_ready() const noexcept { return !io.lines.empty(); }
+        void await_suspend(coroutine_handle<> h) noexcept { io.waiting = h; }
+        string await_resume()
+        {
+            string line = move(io.lines.front());
+            io.lines.pop_front();
+            return line;
+        }
+    };
+    LineAwaiter readLine() { return LineAwaiter{*this}; }
+
+    // co_await io.durable() suspends until changes made so far are saved (batched across sessions)
+    struct DurableAwaiter
+    {
+        SessionIO &io;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(coroutine_handle<> h) noexcept
+        {
+            io.waiting = h;
+            io.awaiting_durable = true;
+        }
+        void await_resume() const noexcept {}
+    };
+    DurableAwaiter durable() { return DurableAwaiter{*this}; }
+
+    // co_await io.offload(work) suspends while 'work' (a password hash or check) runs on the password
+    // workers, so the event loop thread and the bank lock are free meanwhile. The session frame may
+    // be destroyed before the work finishes: the work must own (or share) everything it touches.
+    // Pass a named function rather than a lambda written in the co_await expression; GCC 12 frees
+    // the captures of such temporaries twice.
+    struct OffloadAwaiter
+    {
+        SessionIO &io;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(coroutine_handle<> h) noexcept
+        {
+            io.waiting = h;
+            io.awaiting_offload = true;
+        }
+        void await_resume() const noexcept {}
+    };
+    OffloadAwaiter offload(function<void()> work)
+    {
+        offloaded = move(work);
+        return OffloadAwaiter{*this};
+    }
+};
+
+// Lazily started coroutine that can be co_awaited by another session coroutine
+class SessionTask
+{
+public:
+    struct promise_type
+    {
+        coroutine_handle<> continuation; // Caller to resume when this task finishes
+
+        SessionTask get_return_object() { return SessionTask(coroutine_handle<promise_type>::from_promise(*this)); }
+        suspend_always initial_suspend() noexcept { return {}; }
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            coroutine_handle<> await_suspend(coroutine_handle<promise_type> h) noexcept
+            {
+                coroutine_handle<> next = h.promise().continuation;
+                return next ? next : noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { terminate(); }
+    };
+
+    explicit SessionTask(coroutine_handle<promise_type> h = nullptr) : handle(h) {}
+    SessionTask(SessionTask &&other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    SessionTask &operator=(SessionTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+                handle.destroy();
+            handle = other.handle;
+            other.handle = nullptr;
+        }
+        return *this;
+    }
+    SessionTask(const SessionTask &) = delete;
+    SessionTask &operator=(const SessionTask &) = delete;
+    ~SessionTask()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    // Awaiting a task starts it and resumes the caller once it finishes
+    bool await_ready() const noexcept { return false; }
+    coroutine_handle<> await_suspend(coroutine_handle<> caller) noexcept
+    {
+        handle.promise().continuation = caller;
+        return handle;
+    }
+    void await_resume() const noexcept {}
+
+    void start() { handle.resume(); }
+    bool valid() const { return static_cast<bool>(handle); }
+    bool done() const { return !handle || handle.done(); }
+
+private:
+    coroutine_handle<promise_type> handle;
+};
+
+#ifdef __linux__
+struct ServerState; // Shared by the server event loop threads, defined with runServer
+#endif
+
+// --- Multi-version balances ---
+// Each account keeps a chain of committed (balance, last transaction) versions, newest first,
+// stamped with the commit that wrote them. Writers stay serialized as before (one thread, the
+// server's bank lock or a shard lock); a reader pins the current commit stamp and reads the
+// newest version at or before it, so a scan sees every balance as of one instant while writers
+// keep committing. Superseded versions are freed once no pinned reader can still reach them.
+struct BalanceVersion
+{
+    BalanceVersion(long long paise, const string &when, unsigned long long commit_stamp)
+        : balance(paise), last_transaction(when), stamp(commit_stamp) {}
+
+    long long balance; // Paise
+    string last_transaction;
+    unsigned long long stamp; // Commit that wrote this version
+    atomic<BalanceVersion *> older{nullptr};
+};
+
+// Commit clock, pinned readers and retired versions for one Bank (epoch-based reclamation:
+// a version superseded at stamp S is freed once every pinned reader is at S or later)
+class VersionRegistry
+{
+public:
+    static const int MAX_READERS = 64;
+    static const size_t GC_BATCH = 256;
+
+    // Writer: versions linked with this stamp stay invisible until endCommit(stamp)
+    unsigned long long beginCommit() const { return clock.load(memory_order_relaxed) + 1; }
+    void endCommit(unsigned long long stamp)
+    {
+        clock.store(stamp);
+        if (retired.size() >= GC_BATCH)
+            collect();
+    }
+    // Writer: 'newer' replaced its older version as the head at 'stamp'
+    void retire(BalanceVersion *newer, unsigned long long stamp) { retired.push_back({newer, stamp}); }
+    // Writer: the accounts (and their chains) are being deleted, drop the pending list
+    void forget() { retired.clear(); }
+
+    // Reader: claim a slot announcing the stamp it reads at; returns the slot for unpin()
+    int pin(unsigned long long &stamp)
+    {
+        for (;;)
+        {
+            for (int i = 0; i < MAX_READERS; i++)
+            {
+                unsigned long long observed = clock.load(), free_slot = 0;
+                if (readers[i].load(memory_order_relaxed) != 0 || !readers[i].compare_exchange_strong(free_slot, observed + 1))
+                    continue;
+                // A collect() that missed the announcement has already moved the clock on; re-announce
+                while (clock.load() != observed)
+                {
+                    observed = clock.load();
+                    readers[i].store(observed + 1);
+                }
+                stamp = observed;
+                return i;
+            }
+            this_thread::yield(); // All slots busy
+        }
+    }
+    void unpin(int slot) { readers[slot].store(0, memory_order_release); }
+
+private:
+    void collect()
+    {
+        unsigned long long oldest = clock.load();
+        for (const auto &reader : readers)
+        {
+            unsigned long long announced = reader.load();
+            if (announced != 0)
+                oldest = min(oldest, announced - 1);
+        }
+        // Retirements are in stamp order, so each freed version's own older link was cut before
+        while (!retired.empty() && retired.front().second <= oldest)
+        {
+            delete retired.front().first->older.exchange(nullptr);
+            retired.pop_front();
+        }
+    }
+
+    atomic<unsigned long long> clock{0};
+    array<atomic<unsigned long long>, MAX_READERS> readers{}; // Announced stamp + 1, 0 when free
+    deque<pair<BalanceVersion *, unsigned long long>> retired;  // Writer only
+};
+
+// Balance and last activity of one account published under a sequence lock, so balance reads
+// take no lock at all. The single writer (whoever holds the book's write lock) makes the sequence
+// odd, stores, then makes it even again; a reader retries when the sequence was odd or moved
+// while it copied. No allocation and no shared reader state, so reads scale with cores.
+class BalanceCell
+{
+public:
+    static constexpr size_t ACTIVITY_BYTES = 24; // getCurrentDateTime() text, e.g. "Fri Apr 11 15:03:21 2025"
+
+    // Writer only
+    void publish(long long paise, const string &last_activity)
+    {
+        unsigned long long words[WORDS] = {};
+        memcpy(words, last_activity.data(), min(last_activity.size(), ACTIVITY_BYTES));
+        unsigned start = sequence.load(memory_order_relaxed);
+        sequence.store(start + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        balance.store(paise, memory_order_relaxed);
+        for (size_t i = 0; i < WORDS; i++)
+            activity[i].store(words[i], memory_order_relaxed);
+        sequence.store(start + 2, memory_order_release);
+    }
+
+    // Any thread, no lock: a consistent (balance, last activity) pair
+    void read(long long &paise, string &last_activity) const
+    {
+        char text[ACTIVITY_BYTES];
+        for (;;)
+        {
+            unsigned start = sequence.load(memory_order_acquire);
+            if (start & 1)
+                continue; // Write in progress
+            paise = balance.load(memory_order_relaxed);
+            for (size_t i = 0; i < WORDS; i++)
+            {
+                unsigned long long word = activity[i].load(memory_order_relaxed);
+                memcpy(text + i * 8, &word, 8);
+            }
+            atomic_thread_fence(memory_order_acquire);
+            if (sequence.load(memory_order_relaxed) == start)
+                break;
+        }
+        last_activity.assign(text, strnlen(text, ACTIVITY_BYTES));
+    }
+
+private:
+    static const size_t WORDS = ACTIVITY_BYTES / 8;
+    atomic<unsigned> sequence{0};
+    atomic<long long> balance{0};
+    array<atomic<unsigned long long>, WORDS> activity{};
+};
+
+// Hint that 'address' will be read soon (no-op where the compiler has no prefetch builtin)
+inline void prefetchRead(const void *address)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#else
+    (void)address;
+#endif
+}
+
+// Blocked Bloom filter over account numbers. Each key sets PROBES bits inside a single 512-bit
+// block (one cache line), so a lookup costs one memory access and "definitely absent" answers
+// skip the tree walk. Sized for ~10 bits per account (about 1% false positives).
+class AccountFilter
+{
+public:
+    static const size_t BITS_PER_KEY = 10;
+    static const int PROBES = 7; // 7 x 9-bit bit offsets come out of one 64-bit hash
+
+    // Empty the filter and size it for 'capacity' accounts
+    void reset(size_t capacity)
+    {
+        blocks.assign(capacity * BITS_PER_KEY / 512 + 1, Block{});
+        this->capacity = capacity;
+        count = 0;
+    }
+    bool full() const { return count >= capacity; }
+    size_t size() const { return count; }
+    size_t memoryBytes() const { return blocks.size() * sizeof(Block); }
+
+    void add(const string &acc_no)
+    {
+        unsigned long long key = hashKey(acc_no);
+        Block &block = blocks[blockIndex(key)];
+        unsigned long long bits = mix(key ^ 0x9e3779b97f4a7c15ULL);
+        for (int i = 0; i < PROBES; i++, bits >>= 9)
+            block.words[(bits >> 6) & 7] |= 1ULL << (bits & 63);
+        count++;
+    }
+
+    // False means the account number is certainly not in the book
+    bool mayContain(const string &acc_no) const
+    {
+        if (blocks.empty())
+            return false;
+        unsigned long long key = hashKey(acc_no);
+        const Block &block = blocks[blockIndex(key)];
+        unsigned long long bits = mix(key ^ 0x9e3779b97f4a7c15ULL);
+        for (int i = 0; i < PROBES; i++, bits >>= 9)
+            if ((block.words[(bits >> 6) & 7] & (1ULL << (bits & 63))) == 0)
+                return false;
+        return true;
+    }
+
+    // Start loading the block mayContain(acc_no) will read
+    void prefetch(const string &acc_no) const
+    {
+        if (!blocks.empty())
+            prefetchRead(&blocks[blockIndex(hashKey(acc_no))]);
+    }
+
+private:
+    struct alignas(64) Block
+    {
+        unsigned long long words[8];
+    };
+
+    static unsigned long long mix(unsigned long long x) // splitmix64 finalizer
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+    static unsigned long long hashKey(const string &text) // 64-bit FNV-1a
+    {
+        unsigned long long hash = 1469598103934665603ULL;
+        for (unsigned char c : text)
+            hash = (hash ^ c) * 1099511628211ULL;
+        return mix(hash);
+    }
+    size_t blockIndex(unsigned long long key) const // Upper 32 bits scaled onto the block count
+    {
+        return static_cast<size_t>(((key >> 32) * blocks.size()) >> 32);
+    }
+
+    vector<Block> blocks;
+    size_t capacity = 0;
+    size_t count = 0;
+};
+
+// Bank Account Class
+class Bank
+{
+private:
+    struct AccountNode
+    {
+        string account_number;
+        string name;
+        string dob;
+        string age;
+        string address;
+        string phone;
+        string balance;
+        string acc_type;
+        string creation_date;
+        string last_transaction;
+        AccountNode *left = nullptr;
+        AccountNode *right = nullptr;
+        atomic<BalanceVersion *> versions{nullptr}; // Committed balances, newest first
+        unsigned long long created_stamp = 0;       // Commit that opened the account
+        BalanceCell published;                      // Latest balance for lock-free readers
+
+        // Fields are filled from RECORD_SCHEMA (makeAccountNode or a record decoder)
+        AccountNode() = default;
+
+        ~AccountNode()
+        {
+            BalanceVersion *version = versions.load(memory_order_relaxed);
+            while (version != nullptr)
+            {
+                BalanceVersion *older = version->older.load(memory_order_relaxed);
+                delete version;
+                version = older;
+            }
+        }
+    };
+
+    // --- Account record schema ---
+    // The Bank_Record.csv columns, in file order. Building a node from loose values and the CSV and
+    // binary codecs below are all expanded from this list at compile time (one straight-line step
+    // per field), so a new column is added here and to AccountNode, nowhere else.
+    static constexpr array<string AccountNode::*, 10> RECORD_SCHEMA = {
+        &AccountNode::account_number, &AccountNode::name, &AccountNode::dob, &AccountNode::age,
+        &AccountNode::address, &AccountNode::phone, &AccountNode::balance, &AccountNode::acc_type,
+        &AccountNode::creation_date, &AccountNode::last_transaction};
+    static constexpr size_t RECORD_FIELDS = RECORD_SCHEMA.size();
+    using AccountFields = array<string, RECORD_FIELDS>; // Field values in schema order
+    using RecordIndexes = make_index_sequence<RECORD_FIELDS>;
+
+    // Private helper to allocate a node holding the given fields (moved in)
+    static AccountNode *makeAccountNode(AccountFields &&fields) { return makeAccountNode(fields, RecordIndexes{}); }
+    template <size_t... I>
+    static AccountNode *makeAccountNode(AccountFields &fields, index_sequence<I...>)
+    {
+        AccountNode *node = new AccountNode();
+        ((node->*RECORD_SCHEMA[I] = move(fields[I])), ...);
+        return node;
+    }
+
+    // Private codec: append the account's record as CSV (no newline)
+    static void appendRecordCsv(string &out, const AccountNode *node) { appendRecordCsv(out, node, RecordIndexes{}); }
+    template <size_t... I>
+    static void appendRecordCsv(string &out, const AccountNode *node, index_sequence<I...>)
+    {
+        out.reserve(out.size() + (RECORD_FIELDS + ... + (node->*RECORD_SCHEMA[I]).size()));
+        ((I == 0 ? void() : out.push_back(','), out.append(node->*RECORD_SCHEMA[I])), ...);
+    }
+
+    // Private codec: read the first RECORD_FIELDS comma-separated fields of [p, end) straight into
+    // the node's strings. Returns the position just after them (the next ',' or end), or nullptr
+    // if the line has fewer fields.
+    static const char *decodeRecordCsv(const char *p, const char *end, AccountNode &node)
+    {
+        return decodeRecordCsv(p, end, node, RecordIndexes{});
+    }
+    template <size_t... I>
+    static const char *decodeRecordCsv(const char *p, const char *end, AccountNode &node, index_sequence<I...>)
+    {
+        bool complete = (decodeCsvField<I + 1 == RECORD_FIELDS>(p, end, node.*RECORD_SCHEMA[I]) && ...);
+        return complete ? p : nullptr;
+    }
+    template <bool LAST>
+    static bool decodeCsvField(const char *&p, const char *end, string &field)
+    {
+        const char *comma = static_cast<const char *>(memchr(p, ',', static_cast<size_t>(end - p)));
+        if (comma == nullptr)
+        {
+            if (!LAST)
+                return false;
+            comma = end;
+        }
+        field.assign(p, static_cast<size_t>(comma - p));
+        p = LAST ? comma : comma + 1;
+        return true;
+    }
+
+    // Private codec: append the account's record in binary (each field a varint length and its bytes)
+    static void appendRecordBinary(string &out, const AccountNode *node) { appendRecordBinary(out, node, RecordIndexes{}); }
+    template <size_t... I>
+    static void appendRecordBinary(string &out, const AccountNode *node, index_sequence<I...>)
+    {
+        (appendBinaryField(out, node->*RECORD_SCHEMA[I]), ...);
+    }
+    static void appendBinaryField(string &out, const string &field)
+    {
+        size_t length = field.size();
+        while (length >= 0x80)
+        {
+            out.push_back(static_cast<char>((length & 0x7F) | 0x80));
+            length >>= 7;
+        }
+        out.push_back(static_cast<char>(length));
+        out.append(field);
+    }
+
+    // Private codec: read one binary record from [p, end) into the node; returns the position after
+    // it, or nullptr if the record is truncated
+    static const char *decodeRecordBinary(const char *p, const char *end, AccountNode &node)
+    {
+        return decodeRecordBinary(p, end, node, RecordIndexes{});
+    }
+    template <size_t... I>
+    static const char *decodeRecordBinary(const char *p, const char *end, AccountNode &node, index_sequence<I...>)
+    {
+        bool complete = (decodeBinaryField(p, end, node.*RECORD_SCHEMA[I]) && ...);
+        return complete ? p : nullptr;
+    }
+    static bool decodeBinaryField(const char *&p, const char *end, string &field)
+    {
+        size_t length = 0;
+        for (int shift = 0;; shift += 7)
+        {
+            if (p == end || shift > 28)
+                return false;
+            unsigned char byte = static_cast<unsigned char>(*p++);
+            length |= static_cast<size_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                break;
+        }
+        if (static_cast<size_t>(end - p) < length)
+            return false;
+        field.assign(p, length);
+        p += length;
+        return true;
+    }
+
+    // Append-only list of every account in the book, in opening order. Readers iterate it without
+    // the writers' lock (accounts are never deleted while the book is shared). The chunk table
+    // doubles as the book grows; a replaced table stays allocated until clear() because a reader
+    // may still be indexing through it.
+    class AccountDirectory
+    {
+    public:
+        static const size_t CHUNK_SIZE = 4096;
+
+        AccountDirectory() = default;
+        AccountDirectory(const AccountDirectory &) = delete;
+        AccountDirectory &operator=(const AccountDirectory &) = delete;
+        ~AccountDirectory() { clear(); }
+
+        void append(AccountNode *node) // Writer
+        {
+            size_t n = count.load(memory_order_relaxed);
+            AccountNode ***current = table.load(memory_order_relaxed);
+            if (n / CHUNK_SIZE == table_capacity)
+            {
+                size_t grown = max<size_t>(64, table_capacity * 2);
+                AccountNode ***bigger = new AccountNode **[grown]();
+                copy(current, current + table_capacity, bigger);
+                if (current != nullptr)
+                    retired.push_back(current);
+                table.store(bigger, memory_order_release);
+                table_capacity = grown;
+                current = bigger;
+            }
+            AccountNode **&chunk = current[n / CHUNK_SIZE];
+            if (chunk == nullptr)
+                chunk = new AccountNode *[CHUNK_SIZE];
+            chunk[n % CHUNK_SIZE] = node;
+            count.store(n + 1, memory_order_release); // Publishes the slot, its chunk and the table
+        }
+        size_t size() const { return count.load(memory_order_acquire); }
+        AccountNode *operator[](size_t i) const { return table.load(memory_order_acquire)[i / CHUNK_SIZE][i % CHUNK_SIZE]; }
+        void clear()
+        {
+            AccountNode ***current = table.load(memory_order_relaxed);
+            for (size_t c = 0; c < table_capacity; c++)
+                delete[] current[c];
+            delete[] current;
+            for (AccountNode ***old : retired)
+                delete[] old;
+            retired.clear();
+            table.store(nullptr);
+            table_capacity = 0;
+            count.store(0);
+        }
+
+    private:
+        atomic<AccountNode ***> table{nullptr};
+        size_t table_capacity = 0; // Chunk slots in 'table'; writer only
+        vector<AccountNode ***> retired;
+        atomic<size_t> count{0};
+    };
+
+    // Radix trie over account numbers for prefix search. Edges carry compressed labels and every
+    // node has at least two children or an account, so collecting the first k matches under a
+    // prefix visits O(prefix length + k) nodes. Nodes live in one pool and refer to each other by
+    // index; children are kept sorted by first character so results come out in account order.
+    class AccountTrie
+    {
+    public:
+        AccountTrie() { clear(); }
+
+        void insert(const string &acc_no, AccountNode *account)
+        {
+            uint32_t node = 0;
+            size_t pos = 0;
+            while (pos < acc_no.size())
+            {
+                size_t slot = childSlot(node, acc_no[pos]);
+                vector<uint32_t> &children = nodes[node].children;
+                if (slot == children.size() || nodes[children[slot]].label[0] != acc_no[pos])
+                {
+                    uint32_t leaf = newNode(acc_no.substr(pos));
+                    nodes[leaf].account = account;
+                    nodes[node].children.insert(nodes[node].children.begin() + slot, leaf);
+                    return;
+                }
+                uint32_t child = children[slot];
+                const string &label = nodes[child].label;
+                size_t common = 0;
+                while (common < label.size() && pos + common < acc_no.size() && label[common] == acc_no[pos + common])
+                    common++;
+                if (common < label.size()) // Split the edge at the first mismatch
+                {
+                    uint32_t middle = newNode(nodes[child].label.substr(0, common));
+                    nodes[child].label.erase(0, common);
+                    nodes[middle].children.push_back(child);
+                    nodes[node].children[slot] = middle;
+                    child = middle;
+                }
+                node = child;
+                pos += common;
+            }
+            nodes[node].account = account;
+        }
+
+        // Up to 'limit' accounts whose number starts with 'prefix', in account-number order
+        void findPrefix(const string &prefix, size_t limit, vector<AccountNode *> &out) const
+        {
+            out.clear();
+            uint32_t node = 0;
+            size_t pos = 0;
+            while (pos < prefix.size())
+            {
+                size_t slot = childSlot(node, prefix[pos]);
+                const vector<uint32_t> &children = nodes[node].children;
+                if (slot == children.size())
+                    return;
+                const string &label = nodes[children[slot]].label;
+                size_t span = min(label.size(), prefix.size() - pos);
+                if (label.compare(0, span, prefix, pos, span) != 0)
+                    return;
+                node = children[slot];
+                pos += span;
+            }
+            vector<uint32_t> pending{node}; // Depth-first, smallest child on top
+            while (!pending.empty() && out.size() < limit)
+            {
+                const Node &current = nodes[pending.back()];
+                pending.pop_back();
+                if (current.account != nullptr)
+                    out.push_back(current.account);
+                pending.insert(pending.end(), current.children.rbegin(), current.children.rend());
+            }
+        }
+
+        void clear()
+        {
+            nodes.clear();
+            newNode("");
+        }
+
+    private:
+        struct Node
+        {
+            string label;                   // Characters on the edge into this node
+            AccountNode *account = nullptr; // Account whose number ends here
+            vector<uint32_t> children;      // Sorted by first label character
+        };
+
+        uint32_t newNode(const string &label)
+        {
+            nodes.push_back(Node{label, nullptr, {}});
+            return static_cast<uint32_t>(nodes.size() - 1);
+        }
+        // Position of the child starting with 'c', or where it would be inserted
+        size_t childSlot(uint32_t node, char c) const
+        {
+            const vector<uint32_t> &children = nodes[node].children;
+            size_t slot = 0;
+            while (slot < children.size() && nodes[children[slot]].label[0] < c)
+                slot++;
+            return slot;
+        }
+
+        vector<Node> nodes;
+    };
+
+    // Pinned view of every balance as of one commit; keep it only for the length of a scan
+    class Snapshot
+    {
+    public:
+        explicit Snapshot(VersionRegistry &versions) : registry(versions) { slot = registry.pin(stamp); }
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+        ~Snapshot() { registry.unpin(slot); }
+
+        // Balance version of the account in this snapshot, nullptr if it was opened later
+        const BalanceVersion *read(const AccountNode *account) const
+        {
+            if (account->created_stamp > stamp)
+                return nullptr;
+            const BalanceVersion *version = account->versions.load(memory_order_acquire);
+            while (version != nullptr && version->stamp > stamp)
+                version = version->older.load(memory_order_acquire);
+            return version;
+        }
+
+    private:
+        VersionRegistry &registry;
+        unsigned long long stamp = 0;
+        int slot;
+    };
+
+    AccountNode *root; // Root of the BST
+    VersionRegistry versionRegistry;
+    AccountDirectory accountDirectory;
+    AccountFilter accountFilter; // Fast reject for account numbers that are not in the book
+    // Secondary indexes for teller lookups (several accounts may share a phone or a customer)
+    unordered_multimap<string, AccountNode *> phoneIndex;   // Phone digits -> accounts
+    unordered_multimap<string, AccountNode *> profileIndex; // DOB|lowercase name -> accounts
+    AccountTrie accountTrie; // Account-number prefix search
+    string recordFile; // CSV file this book is loaded from and saved to
+    vector<AccountNode *> snapshotAccounts; // Replica: snapshot records held until the snapshot's END
+
+    friend class ShardedBank; // Shards reach into their books directly under their own locks
+
+    // Private helper to register a new account opened in commit 'stamp' with its first balance
+    // version, the filter, secondary indexes, trie and directory; linking it into the tree is up to
+    // the caller
+    AccountNode *registerAccount(unsigned long long stamp, AccountNode *created)
+    {
+        long long paise = parseAmountToPaise(created->balance);
+        created->created_stamp = stamp;
+        created->versions.store(new BalanceVersion(paise, created->last_transaction, stamp), memory_order_relaxed);
+        created->published.publish(paise, created->last_transaction);
+        if (accountFilter.full())
+            rebuildAccountFilter(2 * accountDirectory.size() + 1024);
+        accountFilter.add(created->account_number);
+        indexProfile(created);
+        accountTrie.insert(created->account_number, created);
+        accountDirectory.append(created);
+        return created;
+    }
+
+    // Private helper to link accounts sorted by account number into a balanced tree in O(n)
+    static AccountNode *linkBalanced(AccountNode *const *accounts, size_t count)
+    {
+        if (count == 0)
+            return nullptr;
+        size_t middle = count / 2;
+        AccountNode *node = accounts[middle];
+        node->left = linkBalanced(accounts, middle);
+        node->right = linkBalanced(accounts + middle + 1, count - middle - 1);
+        return node;
+    }
+
+    // Private helper to put freshly loaded accounts in account-number order, keeping the first of
+    // any duplicate numbers
+    static void sortLoadedAccounts(vector<AccountNode *> &accounts)
+    {
+        auto byNumber = [](const AccountNode *a, const AccountNode *b) { return a->account_number < b->account_number; };
+        if (!is_sorted(accounts.begin(), accounts.end(), byNumber))
+            stable_sort(accounts.begin(), accounts.end(), byNumber);
+        size_t kept = 0;
+        for (size_t i = 0; i < accounts.size(); i++)
+        {
+            if (kept > 0 && accounts[i]->account_number == accounts[kept - 1]->account_number)
+                delete accounts[i];
+            else
+                accounts[kept++] = accounts[i];
+        }
+        accounts.resize(kept);
+    }
+
+    // Private helper to register accounts just loaded in one commit (sorted, not yet in the book)
+    // with the directory, filter, secondary indexes and trie. The structures are independent, so
+    // on a large load each one is filled by its own thread.
+    void registerLoadedAccounts(const vector<AccountNode *> &accounts)
+    {
+        vector<function<void()>> builders;
+        builders.push_back([&]()
+        {
+            for (AccountNode *account : accounts)
+                accountDirectory.append(account);
+            rebuildAccountFilter(accountDirectory.size() + accountDirectory.size() / 2 + 1024);
+        });
+        builders.push_back([&]()
+        {
+            phoneIndex.reserve(phoneIndex.size() + accounts.size());
+            for (AccountNode *account : accounts)
+                phoneIndex.emplace(phoneKey(account->phone), account);
+        });
+        builders.push_back([&]()
+        {
+            profileIndex.reserve(profileIndex.size() + accounts.size());
+            for (AccountNode *account : accounts)
+                profileIndex.emplace(profileKey(account->dob, account->name), account);
+        });
+        builders.push_back([&]()
+        {
+            for (AccountNode *account : accounts)
+                accountTrie.insert(account->account_number, account);
+        });
+
+        if (parallelWorkerCount(accounts.size()) == 1)
+        {
+            for (auto &builder : builders)
+                builder();
+            return;
+        }
+        vector<thread> threads;
+        for (size_t i = 1; i < builders.size(); i++)
+            threads.emplace_back(builders[i]);
+        builders[0]();
+        for (thread &t : threads)
+            t.join();
+    }
+
+    // Private helper for inserting into BST (fields in RECORD_SCHEMA order)
+    AccountNode *insert(AccountNode *node, AccountFields &&fields)
+    {
+        const string &acc_no = fields[0];
+        if (node == nullptr)
+        {
+            unsigned long long stamp = versionRegistry.beginCommit();
+            AccountNode *created = registerAccount(stamp, makeAccountNode(move(fields)));
+            versionRegistry.endCommit(stamp);
+            return created;
+        }
+        if (acc_no < node->account_number)
+        {
+            node->left = insert(node->left, move(fields));
+        }
+        else if (acc_no > node->account_number) // Added check for greater to avoid duplicates or issues
+        {
+            node->right = insert(node->right, move(fields));
+        }
+        return node;
+    }
+
+    // Private helper for searching in BST
+    AccountNode *search(AccountNode *node, const string &acc_no)
+    {
+        if (node == nullptr || node->account_number == acc_no)
+        {
+            return node;
+        }
+        if (acc_no < node->account_number)
+        {
+            return search(node->left, acc_no);
+        }
+        return search(node->right, acc_no);
+    }
+
+    // Private helper to look an account up by number, consulting the filter before the tree
+    AccountNode *findAccount(const string &acc_no)
+    {
+        return accountFilter.mayContain(acc_no) ? search(root, acc_no) : nullptr;
+    }
+
+    // Private helper to look up a batch of account numbers (found[i] is nullptr for unknown
+    // numbers). A single lookup is a chain of dependent cache misses, one per tree level, so up
+    // to LOOKUP_LANES lookups advance in turn: each step prefetches the next node of its lookup
+    // and moves on, and by the time that lookup comes round again its node has arrived.
+    static constexpr size_t LOOKUP_LANES = 16;
+    void findAccounts(const string *acc_nos, size_t count, AccountNode **found)
+    {
+        struct Lane
+        {
+            size_t index;
+            AccountNode *node; // nullptr while the filter block is still being fetched
+        };
+        auto prefetchNode = [](const AccountNode *node)
+        {
+            prefetchRead(&node->account_number); // The key (inline for short numbers)...
+            prefetchRead(&node->left);           // ...and the child links, a few lines further on
+        };
+
+        Lane lanes[LOOKUP_LANES];
+        size_t active = 0, next = 0;
+        for (; active < LOOKUP_LANES && next < count; active++, next++)
+        {
+            accountFilter.prefetch(acc_nos[next]);
+            lanes[active] = {next, nullptr};
+        }
+        while (active > 0)
+        {
+            for (size_t l = 0; l < active;)
+            {
+                Lane &lane = lanes[l];
+                const string &acc_no = acc_nos[lane.index];
+                AccountNode *result = nullptr;
+                bool done;
+                if (lane.node == nullptr)
+                {
+                    done = root == nullptr || !accountFilter.mayContain(acc_no);
+                    lane.node = root;
+                }
+                else
+                {
+                    int order = acc_no.compare(lane.node->account_number);
+                    if (order == 0)
+                    {
+                        result = lane.node;
+                        done = true;
+                    }
+                    else
+                    {
+                        lane.node = order < 0 ? lane.node->left : lane.node->right;
+                        done = lane.node == nullptr;
+                    }
+                }
+                if (!done)
+                {
+                    prefetchNode(lane.node);
+                    l++;
+                    continue;
+                }
+
+                found[lane.index] = result;
+                if (next < count) // Reuse the lane for the next number
+                {
+                    accountFilter.prefetch(acc_nos[next]);
+                    lane = {next++, nullptr};
+                    l++;
+                }
+                else
+                    lane = lanes[--active];
+            }
+        }
+    }
+
+    // Private helper to move money between accounts already looked up (see transfer())
+    TxnStatus transferBetween(AccountNode *from_account, AccountNode *to_account, const string &from_acc_no,
+                              const string &to_acc_no, long long amount);
+
+    // Private helpers for the secondary index keys: phone digits only, DOB plus trimmed lowercase name
+    static string phoneKey(const string &phone)
+    {
+        string key;
+        for (char c : phone)
+            if (isdigit(static_cast<unsigned char>(c)))
+                key.push_back(c);
+        return key;
+    }
+    static string profileKey(const string &dob, const string &name)
+    {
+        size_t first = name.find_first_not_of(" \t"), last = name.find_last_not_of(" \t");
+        string key = dob + "|";
+        if (first != string::npos)
+            for (size_t i = first; i <= last; i++)
+                key.push_back(static_cast<char>(tolower(static_cast<unsigned char>(name[i]))));
+        return key;
+    }
+
+    // Private helpers to add an account to / drop it from the secondary indexes (call unindex
+    // before changing the phone, name or DOB of an account and index again afterwards)
+    void indexProfile(AccountNode *node)
+    {
+        phoneIndex.emplace(phoneKey(node->phone), node);
+        profileIndex.emplace(profileKey(node->dob, node->name), node);
+    }
+    void unindexProfile(AccountNode *node)
+    {
+        auto eraseFrom = [node](unordered_multimap<string, AccountNode *> &index, const string &key)
+        {
+            auto range = index.equal_range(key);
+            for (auto it = range.first; it != range.second; ++it)
+                if (it->second == node)
+                {
+                    index.erase(it);
+                    return;
+                }
+        };
+        eraseFrom(phoneIndex, phoneKey(node->phone));
+        eraseFrom(profileIndex, profileKey(node->dob, node->name));
+    }
+
+    // Private helper to list the accounts filed under 'key', in account-number order
+    static vector<AccountNode *> lookupIndex(const unordered_multimap<string, AccountNode *> &index, const string &key)
+    {
+        vector<AccountNode *> matches;
+        auto range = index.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it)
+            matches.push_back(it->second);
+        sort(matches.begin(), matches.end(),
+             [](const AccountNode *a, const AccountNode *b) { return a->account_number < b->account_number; });
+        return matches;
+    }
+
+    // Private helper to resize the filter and re-add every account in the book
+    void rebuildAccountFilter(size_t capacity)
+    {
+        accountFilter.reset(capacity);
+        for (size_t i = 0, n = accountDirectory.size(); i < n; i++)
+            accountFilter.add(accountDirectory[i]->account_number);
+    }
+
+    // Private helper to collect up to 'count' accounts in ascending order, starting at the
+    // first account number >= from_key (or > from_key when 'inclusive' is false).
+    // Iterative so a degenerate (sorted-insert) tree cannot overflow the call stack.
+    void collectForward(const string &from_key, bool inclusive, size_t count, vector<AccountNode *> &out)
+    {
+        out.clear();
+        vector<AccountNode *> path;
+        AccountNode *node = root;
+        while (node != nullptr) // Seek the lower bound, remembering every ancestor still to visit
+        {
+            if (node->account_number > from_key || (inclusive && node->account_number == from_key))
+            {
+                path.push_back(node);
+                node = node->left;
+            }
+            else
+            {
+                node = node->right;
+            }
+        }
+        while (!path.empty() && out.size() < count)
+        {
+            AccountNode *current = path.back();
+            path.pop_back();
+            out.push_back(current);
+            for (node = current->right; node != nullptr; node = node->left)
+                path.push_back(node);
+        }
+    }
+
+    // Private helper to collect up to 'count' accounts that come just before 'before_key' (ascending order)
+    void collectBackward(const string &before_key, size_t count, vector<AccountNode *> &out)
+    {
+        out.clear();
+        vector<AccountNode *> path;
+        AccountNode *node = root;
+        while (node != nullptr) // Seek the last account number strictly less than before_key
+        {
+            if (node->account_number < before_key)
+            {
+                path.push_back(node);
+                node = node->right;
+            }
+            else
+            {
+                node = node->left;
+            }
+        }
+        while (!path.empty() && out.size() < count)
+        {
+            AccountNode *current = path.back();
+            path.pop_back();
+            out.push_back(current);
+            for (node = current->left; node != nullptr; node = node->right)
+                path.push_back(node);
+        }
+        reverse(out.begin(), out.end());
+    }
+
+    // Private helper to append one listing row to the buffer (same layout as the old setw() output)
+    static void appendAccountRow(string &buffer, const AccountNode *node)
+    {
+        auto appendPadded = [&buffer](const string &field, size_t width)
+        {
+            buffer.append(field);
+            if (field.size() < width)
+                buffer.append(width - field.size(), ' ');
+        };
+        buffer.push_back('\t');
+        appendPadded(node->account_number, 20);
+        appendPadded(node->name, 30);
+        appendPadded(node->acc_type, 20);
+        buffer.append("Rs ");
+        buffer.append(node->balance);
+        buffer.push_back('\n');
+    }
+
+    string listingBuffer; // Reusable buffer for formatting listing pages and exports
+    IdempotencyTable idempotencyKeys; // Replies to keyed server-mode money movements
+    SessionTokens sessionTokens;      // Server-mode logins that other connections may resume
+
+    // Private helper to execute one server-mode request line and build its reply line
+    string dispatchServerCommand(string &session_account, const string &line, bool &modified, bool &quit);
+
+    // Private helper to get an account's published balance for reads without any lock (call with the
+    // book's lock held; the cell lives as long as the account, and a shared book never drops accounts)
+    const BalanceCell *balanceCell(const string &acc_no)
+    {
+        AccountNode *account = findAccount(acc_no);
+        return account == nullptr ? nullptr : &account->published;
+    }
+
+    // Private coroutines for interactive server sessions (the console flows, suspending on input)
+    SessionTask runSession(SessionIO &io);
+    SessionTask sessionLogin(SessionIO &io, string &logged_in_account);
+    SessionTask sessionCustomerMenu(SessionIO &io, const string &acc_no);
+    SessionTask sessionCreateAccount(SessionIO &io);
+    SessionTask sessionTransfer(SessionIO &io, const string &from_acc_no);
+#ifdef __linux__
+    // Private helper run by each server thread: one epoll loop over its share of the connections
+    void serverEventLoop(int listen_fd, bool watch_stdin, ServerState &state);
+    // Private helpers for log-shipping replication (primary side, then replica side)
+    void replicationListener(int listen_fd, ServerState &state);
+    void replicationSender(int fd, ServerState &state);
+    void replicationReceiver(int fd, ServerState &state);
+#endif
+
+    // Private helper to flatten the tree into a vector (ascending account number) for parallel scans
+    void collectAllAccounts(vector<AccountNode *> &out)
+    {
+        out.clear();
+        vector<AccountNode *> path;
+        for (AccountNode *node = root; node != nullptr; node = node->left)
+            path.push_back(node);
+        while (!path.empty())
+        {
+            AccountNode *current = path.back();
+            path.pop_back();
+            out.push_back(current);
+            for (AccountNode *node = current->right; node != nullptr; node = node->left)
+                path.push_back(node);
+        }
+    }
+
+    // Private helper to deallocate BST memory
+    void clearTree(AccountNode *node)
+    {
+        if (node != nullptr)
+        {
+            clearTree(node->left);
+            clearTree(node->right);
+            delete node;
+        }
+    }
+
+    // Private helper to format an account as its Bank_Record.csv line (without newline)
+    static string accountRecordLine(const AccountNode *node)
+    {
+        string line;
+        appendRecordCsv(line, node);
+        return line;
+    }
+
+    // Private helper to publish the current balance and last transaction of the given accounts as
+    // one commit, and to their lock-free balance cells (call after every balance change; null
+    // entries are skipped)
+    void commitVersions(AccountNode *const *accounts, size_t count)
+    {
+        unsigned long long stamp = versionRegistry.beginCommit();
+        for (size_t i = 0; i < count; i++)
+        {
+            AccountNode *account = accounts[i];
+            if (account == nullptr)
+                continue;
+            long long paise = parseAmountToPaise(account->balance);
+            account->published.publish(paise, account->last_transaction);
+            BalanceVersion *previous = account->versions.load(memory_order_relaxed);
+            BalanceVersion *current = new BalanceVersion(paise, account->last_transaction, stamp);
+            current->older.store(previous, memory_order_relaxed);
+            account->versions.store(current, memory_order_release);
+            if (previous != nullptr)
+                versionRegistry.retire(current, stamp);
+        }
+        versionRegistry.endCommit(stamp);
+    }
+    void commitVersions(initializer_list<AccountNode *> accounts) { commitVersions(accounts.begin(), accounts.size()); }
+
+    // Private helper to drop every account (a replica replaces its book with the primary's snapshot).
+    // No snapshot readers may be active.
+    void clearAccounts()
+    {
+        clearTree(root);
+        root = nullptr;
+        accountDirectory.clear();
+        accountFilter.reset(0);
+        phoneIndex.clear();
+        profileIndex.clear();
+        accountTrie.clear();
+        versionRegistry.forget();
+    }
+
+    // Private helper to apply one replication payload (snapshot or streamed record) to this book
+    void applyReplicatedPayload(const string &payload);
+    // Private helper to link the buffered snapshot records into the (empty) book at the snapshot's END
+    void finishReplicatedSnapshot();
+
+    // Private helper to write all accounts to the given file in account-number order.
+    // Iterative so a degenerate tree cannot overflow the call stack. Returns false on I/O failure.
+    bool writeAccountsFile(const string &filename, const string &header = "")
+    {
+        ofstream file(filename);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        if (!header.empty())
+        {
+            file << header << "\n"; // Loader skips it (fewer than 10 fields)
+        }
+
+        vector<AccountNode *> path;
+        string buffer;
+        for (AccountNode *node = root; node != nullptr; node = node->left)
+            path.push_back(node);
+        while (!path.empty())
+        {
+            AccountNode *node = path.back();
+            path.pop_back();
+            appendRecordCsv(buffer, node);
+            buffer.push_back('\n');
+            if (buffer.size() >= EXPORT_FLUSH_BYTES)
+            {
+                file.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+                buffer.clear();
+            }
+            for (node = node->right; node != nullptr; node = node->left)
+                path.push_back(node);
+        }
+        file.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+        file.close();
+        return !file.fail();
+    }
+
+public:
+    // Constructor
+    explicit Bank(const string &record_file = "Bank_Record.csv") : root(nullptr), recordFile(record_file)
+    {
+        loadAccountsFromFile();
+    }
+
+    // Destructor
+    ~Bank()
+    {
+        clearTree(root);
+    }
+
+    // Public method to load accounts from CSV (bulk-built; see the definition)
+    void loadAccountsFromFile();
+
+    // Public method to save accounts to CSV. Written to a temporary file first and swapped in,
+    // so a failed or interrupted save never leaves a half-written Bank_Record.csv behind.
+    void saveAccountsToFile()
+    {
+        if (!writeAccountsFile(recordFile + ".tmp") || !replaceFile(recordFile + ".tmp", recordFile))
+        {
+            setConsoleColor(12);
+            cout << "\n\tError: Could not open " << recordFile << " for saving accounts.";
+            setConsoleColor(7);
+            return;
+        }
+    }
+
+    // Public methods for non-interactive money movements (amounts in paise). They update the
+    // in-memory records and the ledger; callers decide when to call saveAccountsToFile().
+    TxnStatus deposit(const string &acc_no, long long amount);
+    TxnStatus withdraw(const string &acc_no, long long amount);
+    TxnStatus transfer(const string &from_acc_no, const string &to_acc_no, long long amount);
+    // Public method to add an account and its credentials in memory, false if the number is taken.
+    // 'credential' is the stored form of the password (from hashPassword()).
+    bool openAccount(const string &acc_no, const string &name, const string &dob, const string &age,
+                     const string &address, const string &phone, const string &balance,
+                     const string &acc_type, const string &credential);
+
+    // Public method to create a new account
+    void createNewAccount();
+    // Public method to modify an existing account
+    void modifyAccountDetails();
+    // Public method to search for an account
+    void searchAccountRecord();
+    // Public method for deposit/withdrawal transactions
+    void handleDepositWithdrawal();
+    // Public method to display all accounts (for employees)
+    void displayAllAccounts();
+    // Public method to stream the full account listing to a file, returns number of accounts written
+    size_t exportAccountListing(const string &filename);
+    // Public method for fund transfers
+    void performFundTransfer();
+    // Public method to view transaction history
+    void viewTransactionHistory();
+    // Public method for customer to request service
+    void submitServiceRequest();
+    // Public method for employees to process service requests
+    void manageServiceQueue();
+    // Public method to compute dashboard aggregates over all accounts and the ledger
+    AnalyticsReport computeAnalytics();
+    // Public method to show the admin analytics dashboard
+    void showAnalyticsDashboard();
+    // Public method to check that snapshot scans stay consistent under concurrent transfers
+    void runSnapshotConsistencyCheck();
+    // Public method to measure the account filter's false-positive rate and lookup cost
+    void runAccountFilterBenchmark();
+    void runBalanceReadBenchmark();
+    // Public method to benchmark batched lookups against looped single lookups
+    void runBatchLookupBenchmark();
+    // Public method to write statements for every account covering UTC days [from_day, to_day],
+    // one file per worker named <prefix>_partN.txt; returns the number of statements
+    size_t generateStatements(const vector<LedgerEntry> &ledger, long long from_day, long long to_day,
+                              const string &prefix, size_t &files_written);
+    // Public method for employees to produce statements and manage the transaction archive
+    void manageStatements();
+    // Public methods for bulk onboarding. Files use BULK_HEADER's layout: the Bank_Record.csv
+    // fields followed by the account password.
+    static const char *const BULK_HEADER;
+    struct BulkImportResult
+    {
+        size_t imported = 0, duplicates = 0, invalid = 0;
+        bool saved = false;
+    };
+    BulkImportResult bulkImport(const string &path);
+    bool bulkExport(const string &path, size_t &exported);
+    // Public method for employees to import and export accounts in bulk
+    void manageBulkTransfer();
+    // Public method to time loading a synthetic record file of a chosen size
+    void runStartupBenchmark();
+    // Public method to credit interest to every Saving account in one atomic run
+    size_t postInterest(const InterestConfig &config, time_t run_id);
+    // Public method to post interest if the configured period has elapsed
+    void runScheduledInterest();
+    bool runDueStandingOrders(time_t now, size_t &executed, size_t &failed);
+    void manageStandingOrders();
+    void manageStandingOrderRuns();
+    // Public method for employees to configure and run interest posting
+    void manageInterestPosting();
+    // Public method to serve the TCP protocol on a local port until Enter is pressed (or until
+    // the process is stopped when watch_stdin is false). A non-zero replication_port streams
+    // every committed change to read replicas connecting there.
+    void runServer(unsigned short port, unsigned worker_threads, unsigned short replication_port = 0, bool watch_stdin = true);
+    // Public method to follow a primary's replication port and serve read-only queries on 'port'
+    void runReplica(unsigned short primary_port, unsigned short port, bool watch_stdin = true);
+};
+
+// --- Utility Functions Implementation ---
+
+// A simple delay function (shows pending output first, so a message stays up for the delay)
+void fordelay(int milliseconds)
+{
+    cout.flush();
+    this_thread::sleep_for(chrono::milliseconds(milliseconds));
+}
+
+// Read one key without echo, after showing everything written so far. Enter reads as 13 and
+// Backspace as 8, as with _getch() on Windows. Like _getch(), a terminal key is read from the
+// device itself, so the newline a previous `cin >>` left buffered is not taken as a keypress.
+// Redirected input is read through stdin as it comes.
+int readKey()
+{
+    cout.flush();
+#ifdef _WIN32
+    return _getch();
+#else
+    termios saved;
+    if (tcgetattr(STDIN_FILENO, &saved) != 0)
+        return getchar();
+    termios single = saved;
+    single.c_lflag &= ~(ICANON | ECHO);
+    single.c_iflag &= ~ICRNL; // Enter arrives as '\r'
+    single.c_cc[VMIN] = 1;
+    single.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &single);
+    unsigned char key;
+    ssize_t got = read(STDIN_FILENO, &key, 1);
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+    if (got != 1)
+        return EOF;
+    return key == 127 ? 8 : key;
+#endif
+}
+
+// Function to safely close the application
+void close_application(void)
+{
+    displayAppTitle();
+    setConsoleColor(12);
+    cout << "\n\n\n\n\t\tThank you for using our banking system!";
+    setConsoleColor(7);
+    cout << "\n\n\t\tProgram is now closing...\n\n";
+    exit(0); // The renderer shows the last frame as it is destroyed
+}
+
+// Function to set console text color (Windows console attribute numbers, sent as ANSI escapes)
+void setConsoleColor(int color)
+{
+    terminal.setColor(color);
+}
+
+// Function to display the main application title
+void displayAppTitle()
+{
+    terminal.clearScreen(); // Start a new screen
+    setConsoleColor(11); // Cyan color
+    cout << "\n\n\t\t*********************************************";
+    cout << "\n\t\t* *";
+    cout << "\n\t\t* WELCOME TO THE BANKING SYSTEM       *"; // Generic title
+    cout << "\n\t\t* *";
+    cout << "\n\t\t*********************************************\n\n";
+    setConsoleColor(7); // White color
+}
+
+// Function to display the loading screen (data is already loaded, so it is only a blank frame
+// that the next screen replaces)
+void showLoadingScreen()
+{
+    terminal.clearScreen();
+}
+
+// Function to display important instructions to the user
+void showInstructions()
+{
+    displayAppTitle();
+    setConsoleColor(14); // Yellow color
+    cout << "\n\t\tIMPORTANT INSTRUCTIONS:\n";
+    setConsoleColor(7); // White color
+    cout << "\n\t1. Keep your account number and password confidential.";
+    cout << "\n\t2. Do not share your OTP or password with anyone.";
+    cout << "\n\t3. Always log out after completing your transactions.";
+    cout << "\n\t4. Report any suspicious activity to the bank immediately.";
+    cout << "\n\t5. Regularly update your password for security.";
+    cout << "\n\n\tPress any key to continue...";
+    readKey(); // Wait for user input
+}
+
+// Function to display the login page options
+void showLoginPage()
+{
+    displayAppTitle();
+    setConsoleColor(14); // Yellow color
+    cout << "\n\t\tLOGIN PAGE\n";
+    setConsoleColor(7); // White color
+    cout << "\n\t1. Employee Login";
+    cout << "\n\t2. Customer Login";
+    cout << "\n\t3. New Customer Registration";
+    cout << "\n\t4. Return to Main Menu";
+    cout << "\n\t5. Exit";
+    cout << "\n\n\tEnter your choice: ";
+}
+
+// Function to display the signup page title
+void showSignupPage()
+{
+    displayAppTitle();
+    setConsoleColor(14); // Yellow color
+    cout << "\n\t\tNEW CUSTOMER REGISTRATION\n";
+    setConsoleColor(7); // White color
+}
+
+// Function to get password input securely (masked with asterisks)
+string getSecurePasswordInput()
+{
+    string password;
+    int ch;
+    while (true)
+    {
+        ch = readKey(); // Get character without echoing to console
+        if (ch == 13 || ch == EOF) // Enter key (or end of input)
+            break;
+        else if (ch == 8) // Backspace key
+        {
+            if (!password.empty())
+            {
+                cout << "\b \b"; // Erase character from console
+                password.pop_back();
+            }
+        }
+        else if (isprint(ch)) // Check if printable character
+        {
+            password.push_back(static_cast<char>(ch));
+            cout << '*'; // Display asterisk
+        }
+    }
+    cout << endl; // New line after password input
+    return password;
+}
+
+// Function to read one line for an account field, asking again until accountFieldError() accepts it
+string readAccountField(const char *prompt)
+{
+    string value;
+    cout << prompt;
+    getline(cin, value);
+    while (const char *problem = accountFieldError(value))
+    {
+        if (!cin)
+            break; // End of input: nothing more to ask for
+        setConsoleColor(12);
+        cout << "\n\tError: " << problem;
+        setConsoleColor(7);
+        cout << prompt;
+        getline(cin, value);
+    }
+    return value;
+}
+
+// Helper function to get current date and time as a string
+string getCurrentDateTime()
+{
+    return formatDateTime(time(0));
+}
+
+// Format a timestamp like ctime() ("Fri Apr 11 15:03:21 2025") without the newline
+string formatDateTime(time_t now)
+{
+    char buffer[32];
+    // Re-entrant ctime: shard worker threads call this concurrently
+#ifdef _WIN32
+    ctime_s(buffer, sizeof(buffer), &now);
+#else
+    ctime_r(&now, buffer);
+#endif
+    string dt = buffer;
+    // ctime adds a newline, remove it
+    dt.erase(remove(dt.begin(), dt.end(), '\n'), dt.end());
+    return dt;
+}
+
+// Convert a stored balance/amount string (e.g. "1500.000000") to paise
+long long parseAmountToPaise(const string &amount)
+{
+    return llround(strtod(amount.c_str(), nullptr) * 100.0);
+}
+
+// Format paise as a plain rupee amount with two decimals (e.g. "1500.00")
+string formatPaise(long long paise)
+{
+    string sign = paise < 0 ? "-" : "";
+    unsigned long long abs_paise = paise < 0 ? 0ULL - static_cast<unsigned long long>(paise) : paise;
+    string cents = to_string(abs_paise % 100);
+    return sign + to_string(abs_paise / 100) + "." + (cents.size() < 2 ? "0" + cents : cents);
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (Howard Hinnant's algorithm)
+long long daysFromCivil(long long y, unsigned m, unsigned d)
+{
+    y -= m <= 2;
+    const long long era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<long long>(doe) - 719468;
+}
+
+// Parse a getCurrentDateTime() string ("Fri Apr 11 15:03:21 2025") to days since epoch, -1 if malformed.
+// Hand-rolled because it runs once per account in the analytics scan.
+long long parseDateToDays(const string &date_time)
+{
+    static const char *months = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    if (date_time.size() < 24)
+        return -1;
+    const char *found = strstr(months, date_time.substr(4, 3).c_str());
+    if (found == nullptr)
+        return -1;
+    unsigned month = static_cast<unsigned>((found - months) / 3) + 1;
+    unsigned day = static_cast<unsigned>(atoi(date_time.c_str() + 8));
+    long long year = atoll(date_time.c_str() + date_time.size() - 4);
+    if (day == 0 || day > 31 || year <= 0)
+        return -1;
+    return daysFromCivil(year, month, day);
+}
+
+// User-facing text for a failed money movement
+const char *txnStatusMessage(TxnStatus status)
+{
+    switch (status)
+    {
+    case TxnStatus::Ok: return "Success";
+    case TxnStatus::NoSuchAccount: return "Account Doesn't Exist!";
+    case TxnStatus::NoSuchRecipient: return "Recipient Account Doesn't Exist!";
+    case TxnStatus::SameAccount: return "Cannot transfer to the same account!";
+    case TxnStatus::InvalidAmount: return "Invalid amount.";
+    case TxnStatus::InsufficientFunds: return "Insufficient Balance!";
+    case TxnStatus::StorageError: return "Could not save the transaction, please try again.";
+    case TxnStatus::VelocityLimit: return "Transaction blocked by the velocity limits, please contact the bank.";
+    }
+    return "Unknown error";
+}
+
+// Service request type for the choice numbers used by submitServiceRequest
+string serviceTypeName(int service_choice)
+{
+    switch (service_choice)
+    {
+    case 1: return "Technical Issue";
+    case 2: return "Account Query";
+    case 3: return "Loan Information";
+    default: return "Other";
+    }
+}
+
+// Write ledger entries in the Transaction_log.csv line format
+void appendLedgerEntries(const vector<LedgerEntry> &entries, ostream &out)
+{
+    for (const LedgerEntry &entry : entries)
+    {
+        out << entry.timestamp << "," << entry.kind << "," << entry.account << ","
+            << entry.counterparty << "," << entry.amount << "\n";
+    }
+}
+
+// Split one CSV line on commas (fields never contain commas in this application's files)
+vector<string> splitCsvLine(const string &line)
+{
+    vector<string> fields;
+    size_t start = 0, end;
+    while ((end = line.find(',', start)) != string::npos)
+    {
+        fields.push_back(line.substr(start, end - start));
+        start = end + 1;
+    }
+    fields.push_back(line.substr(start));
+    return fields;
+}
+
+// Why a typed account field can't be stored in the CSV files, nullptr if it can
+const char *accountFieldError(const string &value)
+{
+    if (value.empty())
+        return "This field cannot be empty.";
+    for (unsigned char ch : value)
+    {
+        if (ch == ',')
+            return "Commas are not allowed.";
+        if (iscntrl(ch))
+            return "Control characters are not allowed.";
+    }
+    return nullptr;
+}
+
+// Send a committed movement to the replicas, which replay it on their balances
+void publishLedgerEntry(const LedgerEntry &entry)
+{
+    if (replicationLog != nullptr)
+    {
+        replicationLog->publish("L," + to_string(static_cast<long long>(entry.timestamp)) + "," + entry.kind + "," +
+                                entry.account + "," + entry.counterparty + "," + to_string(entry.amount));
+    }
+}
+
+// Append a movement to the in-memory ledger and to Transaction_log.csv
+void recordTransaction(const string &kind, const string &account, const string &counterparty, long long amount)
+{
+    LedgerEntry entry{time(0), kind, account, counterparty, amount};
+    transactionLedger.push_back(entry);
+    publishLedgerEntry(entry);
+    if (ledgerBatch != nullptr)
+    {
+        ledgerBatch->push_back(entry);
+        return;
+    }
+
+    ofstream file("Transaction_log.csv", ios::app);
+    if (!file.is_open())
+    {
+        setConsoleColor(12);
+        cout << "\n\tError: Could not open Transaction_log.csv for writing.";
+        setConsoleColor(7);
+        return;
+    }
+    appendLedgerEntries({entry}, file);
+}
+
+// Rewrite Transaction_log.csv from the in-memory ledger (used when a replica takes over)
+bool saveTransactionLedger()
+{
+    ofstream file("Transaction_log.csv.tmp");
+    if (!file.is_open())
+        return false;
+    appendLedgerEntries(transactionLedger, file);
+    file.close();
+    return !file.fail() && replaceFile("Transaction_log.csv.tmp", "Transaction_log.csv");
+}
+
+// Atomically replace 'to' with 'from' (rename over an existing file)
+bool replaceFile(const string &from, const string &to)
+{
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+// Load interest settings (annual_rate_bp,postings_per_year,last_run), defaults if missing
+InterestConfig loadInterestConfig()
+{
+    InterestConfig config;
+    ifstream file("Interest_config.csv");
+    string line;
+    if (file.is_open() && getline(file, line))
+    {
+        long long rate = 0, last_run = 0;
+        int postings = 0;
+        if (sscanf(line.c_str(), "%lld,%d,%lld", &rate, &postings, &last_run) == 3 && rate >= 0 && postings > 0)
+        {
+            config.annual_rate_bp = rate;
+            config.postings_per_year = postings;
+            config.last_run = static_cast<time_t>(last_run);
+        }
+    }
+    return config;
+}
+
+bool saveInterestConfig(const InterestConfig &config)
+{
+    ofstream file("Interest_config.csv.tmp");
+    if (!file.is_open())
+        return false;
+    file << config.annual_rate_bp << "," << config.postings_per_year << "," << static_cast<long long>(config.last_run) << "\n";
+    file.close();
+    return !file.fail() && replaceFile("Interest_config.csv.tmp", "Interest_config.csv");
+}
+
+// Load velocity limits (count,amount per minute/hour/day then distinct recipients), all off if missing
+VelocityRules loadVelocityRules()
+{
+    VelocityRules rules;
+    ifstream file("Velocity_rules.csv");
+    string line;
+    if (file.is_open() && getline(file, line))
+    {
+        VelocityRules loaded;
+        if (sscanf(line.c_str(), "%d,%lld,%d,%lld,%d,%lld,%d", &loaded.max_count[0], &loaded.max_amount[0],
+                   &loaded.max_count[1], &loaded.max_amount[1], &loaded.max_count[2], &loaded.max_amount[2],
+                   &loaded.max_counterparties_day) == 7)
+        {
+            rules = loaded;
+        }
+    }
+    return rules;
+}
+
+bool saveVelocityRules(const VelocityRules &rules)
+{
+    ofstream file("Velocity_rules.csv.tmp");
+    if (!file.is_open())
+        return false;
+    for (int w = 0; w < VELOCITY_WINDOWS; w++)
+        file << rules.max_count[w] << "," << rules.max_amount[w] << ",";
+    file << rules.max_counterparties_day << "\n";
+    file.close();
+    return !file.fail() && replaceFile("Velocity_rules.csv.tmp", "Velocity_rules.csv");
+}
+
+// Load the password hashing cost (PBKDF2 iterations), the default if missing
+unsigned loadPasswordCost()
+{
+    ifstream file("Password_config.csv");
+    unsigned long iterations = 0;
+    if (file >> iterations && iterations >= 1000 && iterations <= 10000000)
+        return static_cast<unsigned>(iterations);
+    return DEFAULT_PASSWORD_ITERATIONS;
+}
+
+bool savePasswordCost(unsigned iterations)
+{
+    ofstream file("Password_config.csv.tmp");
+    if (!file.is_open())
+        return false;
+    file << iterations << "\n";
+    file.close();
+    return !file.fail() && replaceFile("Password_config.csv.tmp", "Password_config.csv");
+}
+
+// First line of Bank_Record.csv. A batch run writes its records with a "#run,..." stamp there
+// (the loader skips it), so recovery can tell whether the run's records were swapped in.
+static string recordFileStamp()
+{
+    ifstream file("Bank_Record.csv");
+    string line;
+    getline(file, line);
+    if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+    return line;
+}
+
+// Finish or roll back an interest run interrupted by a crash. The commit point of a run is the
+// rename of Bank_Record.csv.tmp, stamped "#run,interest,<run id>"; its ledger entries wait in
+// Interest_run.pending, which is only written once the stamped records are on disk.
+void recoverInterestRun()
+{
+    ifstream pending("Interest_run.pending");
+    if (!pending.is_open())
+        return;
+
+    string header;
+    getline(pending, header);
+    long long run_id = 0;
+    if (sscanf(header.c_str(), "run,%lld", &run_id) != 1 || recordFileStamp() != "#run,interest," + to_string(run_id))
+    {
+        // Crashed before the records were swapped in: nothing was committed
+        pending.close();
+        remove("Interest_run.pending");
+        remove("Bank_Record.csv.tmp");
+        return;
+    }
+
+    // Records were committed, make sure the ledger and config caught up
+    string run_tag = "INTEREST-RUN-" + to_string(run_id);
+    bool logged = any_of(transactionLedger.begin(), transactionLedger.end(),
+                         [&run_tag](const LedgerEntry &entry) { return entry.counterparty == run_tag; });
+    if (!logged)
+    {
+        ofstream ledger("Transaction_log.csv", ios::app);
+        ledger << pending.rdbuf();
+        ledger.close();
+        loadTransactionLedger();
+    }
+    pending.close();
+
+    InterestConfig config = loadInterestConfig();
+    config.last_run = static_cast<time_t>(run_id);
+    saveInterestConfig(config);
+    remove("Interest_run.pending");
+}
+
+// Finish a standing order run that crashed after Bank_Record.csv was swapped in (its first line
+// carries the run's stamp): cut the ledger and the journal back to their size before the run and
+// append the staged lines, so the run is logged exactly once. A run whose stamp is not in
+// Bank_Record.csv committed nothing and is dropped.
+void recoverStandingOrderRun()
+{
+    ifstream pending("Standing_orders.pending", ios::binary);
+    if (!pending.is_open())
+        return;
+
+    string header;
+    getline(pending, header);
+    unsigned long long ledger_size = 0, journal_size = 0, ledger_lines = 0, run_stamp = 0;
+    if (sscanf(header.c_str(), "run,%llu,%llu,%llu,%llu", &ledger_size, &journal_size, &ledger_lines, &run_stamp) != 4 ||
+        recordFileStamp() != "#run,standing," + to_string(run_stamp))
+    {
+        pending.close();
+        remove("Standing_orders.pending");
+        remove("Bank_Record.csv.tmp");
+        return;
+    }
+
+    string ledger_part, journal_part, line;
+    for (unsigned long long i = 0; i < ledger_lines && getline(pending, line); i++)
+        ledger_part += line + "\n";
+    while (getline(pending, line))
+        journal_part += line + "\n";
+    pending.close();
+
+    error_code error;
+    filesystem::resize_file("Transaction_log.csv", ledger_size, error);
+    filesystem::resize_file("Standing_orders.csv", journal_size, error);
+    ofstream ledger("Transaction_log.csv", ios::app | ios::binary);
+    ledger << ledger_part;
+    ledger.close();
+    ofstream journal("Standing_orders.csv", ios::app | ios::binary);
+    journal << journal_part;
+    journal.close();
+    if (!ledger.fail() && !journal.fail())
+        remove("Standing_orders.pending");
+}
+
+// Load the persisted ledger (timestamp,kind,account,counterparty,amount_paise)
+void loadTransactionLedger()
+{
+    transactionLedger.clear(); // main() re-runs on logout, avoid duplicating entries
+    ifstream file("Transaction_log.csv");
+    if (!file.is_open())
+        return;
+
+    string line;
+    while (getline(file, line))
+    {
+        vector<string> tokens;
+        size_t start = 0;
+        size_t end = line.find(',');
+        while (end != string::npos)
+        {
+            tokens.push_back(line.substr(start, end - start));
+            start = end + 1;
+            end = line.find(',', start);
+        }
+        tokens.push_back(line.substr(start));
+
+        if (tokens.size() >= 5)
+        {
+            transactionLedger.push_back({static_cast<time_t>(atoll(tokens[0].c_str())), tokens[1], tokens[2],
+                                         tokens[3], atoll(tokens[4].c_str())});
+        }
+    }
+}
+
+
+// --- Transaction archive ---
+// Old ledger entries move to Transaction_archive.bin, a sequence of column-wise blocks of up to
+// BLOCK_ENTRIES entries. Each block header carries its time range and a dictionary of the account
+// numbers and kinds it mentions (text front-coded, then all-digit account numbers as sorted deltas),
+// so range scans and per-account filters skip whole blocks without decompressing them. The columns
+// are timestamp deltas, dictionary indexes and amounts as varints, compressed with a small LZ77 coder.
+//
+// Block: "TXA1" count min_ts max_ts covered_until dict_size <dict> raw_size packed_size <packed>
+// (all numbers varints). covered_until is the archiving cutoff: every ledger entry before it has
+// been archived, which makes a crash between writing the archive and trimming the log harmless.
+class TransactionArchive
+{
+public:
+    static const size_t BLOCK_ENTRIES = 4096;
+
+    // Append 'entries' (in ledger order, all before covered_until) as new blocks. Returns the bytes written.
+    static size_t append(const string &path, const vector<LedgerEntry> &entries, time_t covered_until)
+    {
+        FILE *file = fopen(path.c_str(), "ab");
+        if (file == nullptr)
+            return 0;
+        size_t written = 0, begin = 0;
+        bool ok = true;
+        do // At least one block, so an empty run still records the new cutoff
+        {
+            size_t end = min(entries.size(), begin + BLOCK_ENTRIES);
+            string block = encodeBlock(entries, begin, end, covered_until);
+            ok = fwrite(block.data(), 1, block.size(), file) == block.size();
+            written += block.size();
+            begin = end;
+        } while (ok && begin < entries.size());
+        ok = fflush(file) == 0 && ok;
+#ifdef _WIN32
+        ok = _commit(_fileno(file)) == 0 && ok;
+#else
+        ok = fsync(fileno(file)) == 0 && ok;
+#endif
+        return fclose(file) == 0 && ok ? written : 0;
+    }
+
+    // Entries with from <= timestamp <= to, optionally only those touching 'account' (as either party)
+    static bool scan(const string &path, time_t from, time_t to, const string &account, vector<LedgerEntry> &out,
+                     size_t *blocks_read = nullptr, size_t *blocks_skipped = nullptr)
+    {
+        ifstream file(path, ios::binary);
+        if (!file.is_open())
+            return true; // Nothing archived yet
+        while (true)
+        {
+            BlockInfo info;
+            if (!readBlockInfo(file, info))
+                return file.eof();
+            bool wanted = info.count > 0 && info.max_ts >= from && info.min_ts <= to &&
+                          (account.empty() || dictionaryCode(info, account) >= 0);
+            if (!wanted)
+            {
+                file.seekg(static_cast<streamoff>(info.packed_size), ios::cur);
+                if (blocks_skipped)
+                    (*blocks_skipped)++;
+                continue;
+            }
+            string packed(info.packed_size, '\0');
+            string raw;
+            if (!file.read(&packed[0], static_cast<streamsize>(packed.size())) ||
+                !lzDecompress(packed, info.raw_size, raw) || !decodeColumns(info, raw, from, to, account, out))
+                return false;
+            if (blocks_read)
+                (*blocks_read)++;
+        }
+    }
+
+    // Cutoff of the last archiving run, 0 when nothing has been archived
+    static time_t coveredUntil(const string &path)
+    {
+        ifstream file(path, ios::binary);
+        time_t covered = 0;
+        BlockInfo info;
+        while (file.is_open() && readBlockInfo(file, info))
+        {
+            covered = max(covered, info.covered_until);
+            file.seekg(static_cast<streamoff>(info.packed_size), ios::cur);
+        }
+        return covered;
+    }
+
+private:
+    struct BlockInfo
+    {
+        size_t count = 0;
+        time_t min_ts = 0, max_ts = 0, covered_until = 0;
+        vector<string> dictionary; // Text entries (sorted), then numeric ones (sorted by length, then value)
+        size_t text_entries = 0;
+        size_t raw_size = 0, packed_size = 0;
+    };
+
+    static void putVarint(string &out, unsigned long long value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+    static bool getVarint(const string &in, size_t &pos, unsigned long long &value)
+    {
+        value = 0;
+        for (int shift = 0; pos < in.size() && shift < 64; shift += 7)
+        {
+            unsigned char byte = static_cast<unsigned char>(in[pos++]);
+            value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+    static bool readVarint(istream &in, unsigned long long &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            int byte = in.get();
+            if (byte == EOF)
+                return false;
+            value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+    static unsigned long long zigzag(long long value) { return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63); }
+    static long long unzigzag(unsigned long long value) { return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1); }
+
+    static string encodeBlock(const vector<LedgerEntry> &entries, size_t begin, size_t end, time_t covered_until)
+    {
+        vector<string> dictionary;
+        time_t min_ts = begin < end ? entries[begin].timestamp : 0, max_ts = min_ts;
+        for (size_t i = begin; i < end; i++)
+        {
+            dictionary.push_back(entries[i].kind);
+            dictionary.push_back(entries[i].account);
+            dictionary.push_back(entries[i].counterparty);
+            min_ts = min(min_ts, entries[i].timestamp);
+            max_ts = max(max_ts, entries[i].timestamp);
+        }
+        sort(dictionary.begin(), dictionary.end(), dictionaryOrder);
+        dictionary.erase(unique(dictionary.begin(), dictionary.end()), dictionary.end());
+        unordered_map<string, unsigned long long> code;
+        for (size_t d = 0; d < dictionary.size(); d++)
+            code.emplace(dictionary[d], d);
+        size_t text_entries = 0;
+        while (text_entries < dictionary.size() && !isNumeric(dictionary[text_entries]))
+            text_entries++;
+
+        // Text part: shared prefix with the previous string, then the rest
+        string dict;
+        putVarint(dict, text_entries);
+        for (size_t d = 0; d < text_entries; d++)
+        {
+            size_t shared = 0;
+            if (d > 0)
+                while (shared < dictionary[d].size() && shared < dictionary[d - 1].size() && dictionary[d][shared] == dictionary[d - 1][shared])
+                    shared++;
+            putVarint(dict, shared);
+            putVarint(dict, dictionary[d].size() - shared);
+            dict.append(dictionary[d], shared, string::npos);
+        }
+        // Numeric part: (gap from the previous value << 1 | new digit count follows), usually one byte
+        putVarint(dict, dictionary.size() - text_entries);
+        unsigned long long previous_value = 0;
+        size_t previous_digits = 0;
+        for (size_t d = text_entries; d < dictionary.size(); d++)
+        {
+            unsigned long long value = stoull(dictionary[d]);
+            bool new_width = dictionary[d].size() != previous_digits;
+            putVarint(dict, ((new_width ? value : value - previous_value) << 1) | (new_width ? 1 : 0));
+            if (new_width)
+                putVarint(dict, dictionary[d].size());
+            previous_value = value;
+            previous_digits = dictionary[d].size();
+        }
+
+        // Columns, one after another
+        string raw;
+        time_t previous = min_ts;
+        for (size_t i = begin; i < end; i++)
+        {
+            putVarint(raw, zigzag(static_cast<long long>(entries[i].timestamp - previous)));
+            previous = entries[i].timestamp;
+        }
+        for (size_t i = begin; i < end; i++)
+            putVarint(raw, code[entries[i].kind]);
+        for (size_t i = begin; i < end; i++)
+            putVarint(raw, code[entries[i].account]);
+        for (size_t i = begin; i < end; i++)
+            putVarint(raw, code[entries[i].counterparty]);
+        for (size_t i = begin; i < end; i++)
+            putVarint(raw, zigzag(entries[i].amount));
+        string packed = lzCompress(raw);
+
+        string block = "TXA1";
+        putVarint(block, end - begin);
+        putVarint(block, static_cast<unsigned long long>(min_ts));
+        putVarint(block, static_cast<unsigned long long>(max_ts));
+        putVarint(block, static_cast<unsigned long long>(covered_until));
+        putVarint(block, dict.size());
+        block += dict;
+        putVarint(block, raw.size());
+        putVarint(block, packed.size());
+        block += packed;
+        return block;
+    }
+
+    static bool readBlockInfo(istream &in, BlockInfo &info)
+    {
+        char magic[4];
+        unsigned long long count, min_ts, max_ts, covered, dict_size, raw_size, packed_size;
+        if (!in.read(magic, 4) || memcmp(magic, "TXA1", 4) != 0 || !readVarint(in, count) || !readVarint(in, min_ts) ||
+            !readVarint(in, max_ts) || !readVarint(in, covered) || !readVarint(in, dict_size))
+            return false;
+        string dict(dict_size, '\0');
+        if (!in.read(&dict[0], static_cast<streamsize>(dict_size)) || !readVarint(in, raw_size) || !readVarint(in, packed_size))
+            return false;
+
+        info.count = count;
+        info.min_ts = static_cast<time_t>(min_ts);
+        info.max_ts = static_cast<time_t>(max_ts);
+        info.covered_until = static_cast<time_t>(covered);
+        info.raw_size = raw_size;
+        info.packed_size = packed_size;
+        info.dictionary.clear();
+        size_t pos = 0;
+        unsigned long long entries, shared, rest;
+        if (!getVarint(dict, pos, entries))
+            return false;
+        for (unsigned long long d = 0; d < entries; d++)
+        {
+            if (!getVarint(dict, pos, shared) || !getVarint(dict, pos, rest) || pos + rest > dict.size() ||
+                (d > 0 && shared > info.dictionary.back().size()) || (d == 0 && shared != 0))
+                return false;
+            info.dictionary.push_back((d > 0 ? info.dictionary.back().substr(0, shared) : string()) + dict.substr(pos, rest));
+            pos += rest;
+        }
+        info.text_entries = info.dictionary.size();
+        unsigned long long value = 0, packed, digits = 0;
+        if (!getVarint(dict, pos, entries))
+            return false;
+        char number[24];
+        for (unsigned long long d = 0; d < entries; d++)
+        {
+            if (!getVarint(dict, pos, packed) || ((packed & 1) && !getVarint(dict, pos, digits)) || digits == 0 || digits > 19)
+                return false;
+            value = (packed & 1) ? packed >> 1 : value + (packed >> 1);
+            snprintf(number, sizeof(number), "%0*llu", static_cast<int>(digits), value);
+            info.dictionary.push_back(number);
+        }
+        return pos == dict.size();
+    }
+
+    // All-digit strings that fit a 64-bit value are stored as numbers
+    static bool isNumeric(const string &value)
+    {
+        return !value.empty() && value.size() <= 19 && all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; });
+    }
+    // Text first (lexicographic), then numbers by digit count and value
+    static bool dictionaryOrder(const string &a, const string &b)
+    {
+        bool a_numeric = isNumeric(a), b_numeric = isNumeric(b);
+        if (a_numeric != b_numeric)
+            return b_numeric;
+        if (a_numeric && a.size() != b.size())
+            return a.size() < b.size();
+        return a < b;
+    }
+    // Index of 'value' in a block dictionary, or -1
+    static long long dictionaryCode(const BlockInfo &info, const string &value)
+    {
+        auto first = info.dictionary.begin() + (isNumeric(value) ? static_cast<long long>(info.text_entries) : 0);
+        auto last = isNumeric(value) ? info.dictionary.end() : info.dictionary.begin() + static_cast<long long>(info.text_entries);
+        auto found = lower_bound(first, last, value, dictionaryOrder);
+        return found != last && *found == value ? found - info.dictionary.begin() : -1;
+    }
+
+    static bool decodeColumns(const BlockInfo &info, const string &raw, time_t from, time_t to, const string &account,
+                              vector<LedgerEntry> &out)
+    {
+        const size_t n = info.count;
+        vector<unsigned long long> columns(5 * n);
+        size_t pos = 0;
+        for (unsigned long long &value : columns)
+        {
+            if (!getVarint(raw, pos, value))
+                return false;
+        }
+        const size_t dictionary_size = info.dictionary.size();
+        const long long account_code = account.empty() ? -1 : dictionaryCode(info, account);
+        time_t timestamp = info.min_ts;
+        for (size_t i = 0; i < n; i++)
+        {
+            timestamp += static_cast<time_t>(unzigzag(columns[i]));
+            unsigned long long kind = columns[n + i], from_account = columns[2 * n + i], counterparty = columns[3 * n + i];
+            if (kind >= dictionary_size || from_account >= dictionary_size || counterparty >= dictionary_size)
+                return false;
+            if (timestamp < from || timestamp > to)
+                continue;
+            if (account_code >= 0 && static_cast<long long>(from_account) != account_code && static_cast<long long>(counterparty) != account_code)
+                continue;
+            out.push_back({timestamp, info.dictionary[kind], info.dictionary[from_account], info.dictionary[counterparty],
+                           unzigzag(columns[4 * n + i])});
+        }
+        return true;
+    }
+
+    // LZ77 with a 4-byte hash table. Tokens: literal count, literals, then (match length - 4, offset),
+    // repeated; the output size tells the decoder where the last literal run ends.
+    static string lzCompress(const string &in)
+    {
+        const size_t MIN_MATCH = 4, HASH_BITS = 14;
+        vector<size_t> last_seen(size_t(1) << HASH_BITS, SIZE_MAX);
+        string out;
+        size_t literal_start = 0, pos = 0;
+        auto hashAt = [&in](size_t at)
+        {
+            uint32_t word;
+            memcpy(&word, in.data() + at, 4);
+            return (word * 2654435761u) >> (32 - HASH_BITS);
+        };
+        while (pos + MIN_MATCH <= in.size())
+        {
+            uint32_t h = hashAt(pos);
+            size_t candidate = last_seen[h];
+            last_seen[h] = pos;
+            if (candidate == SIZE_MAX || memcmp(in.data() + candidate, in.data() + pos, MIN_MATCH) != 0)
+            {
+                pos++;
+                continue;
+            }
+            size_t length = MIN_MATCH;
+            while (pos + length < in.size() && in[candidate + length] == in[pos + length])
+                length++;
+            putVarint(out, pos - literal_start);
+            out.append(in, literal_start, pos - literal_start);
+            putVarint(out, length - MIN_MATCH);
+            putVarint(out, pos - candidate);
+            pos += length;
+            literal_start = pos;
+        }
+        putVarint(out, in.size() - literal_start);
+        out.append(in, literal_start, string::npos);
+        return out;
+    }
+
+    static bool lzDecompress(const string &in, size_t raw_size, string &out)
+    {
+        out.clear();
+        out.reserve(raw_size);
+        size_t pos = 0;
+        unsigned long long literals, length, offset;
+        while (true)
+        {
+            if (!getVarint(in, pos, literals) || pos + literals > in.size() || out.size() + literals > raw_size)
+                return false;
+            out.append(in, pos, literals);
+            pos += literals;
+            if (out.size() == raw_size)
+                return pos == in.size();
+            if (!getVarint(in, pos, length) || !getVarint(in, pos, offset) || offset == 0 || offset > out.size() ||
+                out.size() + length + 4 > raw_size)
+                return false;
+            size_t source = out.size() - offset;
+            for (unsigned long long i = 0; i < length + 4; i++) // Byte by byte: matches may overlap themselves
+                out.push_back(out[source + i]);
+        }
+    }
+};
+
+// Move ledger entries older than 'cutoff' into the archive and trim Transaction_log.csv.
+// Reports the archive bytes written and what the same entries took as CSV text.
+bool archiveLedgerBefore(time_t cutoff, size_t &archived, size_t &archive_bytes, size_t &text_bytes)
+{
+    const string path = "Transaction_archive.bin";
+    time_t covered = TransactionArchive::coveredUntil(path);
+    cutoff = max(cutoff, covered);
+    vector<LedgerEntry> moving, keeping;
+    for (const LedgerEntry &entry : transactionLedger)
+    {
+        if (entry.timestamp >= cutoff)
+            keeping.push_back(entry);
+        else if (entry.timestamp >= covered) // Older ones were archived by a run that crashed before trimming
+            moving.push_back(entry);
+    }
+    ostringstream text;
+    appendLedgerEntries(moving, text);
+    text_bytes = text.str().size();
+    archived = moving.size();
+    archive_bytes = TransactionArchive::append(path, moving, cutoff);
+    if (archive_bytes == 0)
+        return false;
+    transactionLedger.swap(keeping);
+    return saveTransactionLedger();
+}
+
+// Number of worker threads for a parallel scan over 'items' elements
+size_t parallelWorkerCount(size_t items)
+{
+    const size_t MIN_ITEMS_PER_WORKER = 16384; // Below this a thread costs more than it saves
+    size_t hardware = thread::hardware_concurrency();
+    if (hardware == 0)
+        hardware = 1;
+    return max<size_t>(1, min(hardware, items / MIN_ITEMS_PER_WORKER));
+}
+
+// Split [0, items) into 'workers' contiguous chunks and run fn(begin, end, chunk_index) on each,
+// the first chunk on the calling thread. Callers give each chunk its own partial result.
+template <typename ChunkFn>
+void runParallelChunks(size_t items, size_t workers, ChunkFn fn)
+{
+    vector<thread> threads;
+    size_t chunk = (items + workers - 1) / workers;
+    for (size_t w = 1; w < workers; w++)
+    {
+        size_t begin = min(items, w * chunk);
+        size_t end = min(items, begin + chunk);
+        threads.emplace_back(fn, begin, end, w);
+    }
+    fn(0, min(items, chunk), 0);
+    for (thread &t : threads)
+        t.join();
+}
+
+// Load one "id,password" credentials file into the given map; false if the file doesn't exist
+bool loadCredentialFile(const string &filename, map<string, string> &credentials)
+{
+    ifstream file(filename);
+    if (!file.is_open())
+        return false;
+    string line;
+    while (getline(file, line))
+    {
+        size_t pos = line.find(',');
+        if (pos != string::npos)
+        {
+            string id = line.substr(0, pos);
+            string pass = line.substr(pos + 1);
+            credentials[id] = pass;
+        }
+    }
+    file.close();
+    return true;
+}
+
+// Load all credentials from CSV files into maps (the two files are read concurrently)
+void loadAllCredentials()
+{
+    // If Account_info.csv doesn't exist, accountCredentials map remains empty, which is fine
+    thread account_loader([]() { loadCredentialFile("Account_info.csv", accountCredentials); });
+    bool employees_found = loadCredentialFile("Employee_info.csv", employeeCredentials);
+    account_loader.join();
+
+    if (!employees_found)
+    {
+        // Create a default admin if Employee_info.csv does not exist
+        employeeCredentials["admin"] = hashPassword("admin123");
+        saveAllCredentials(); // Save this default admin to the file
+    }
+}
+
+// Save all credentials from maps to CSV files
+void saveAllCredentials()
+{
+    // Save employee credentials to Employee_info.csv
+    ofstream empFile("Employee_info.csv");
+    if (empFile.is_open())
+    {
+        for (const auto &pair : employeeCredentials)
+        {
+            empFile << pair.first << "," << pair.second << "\n";
+        }
+        empFile.close();
+    }
+    else
+    {
+        setConsoleColor(12);
+        cout << "\n\tError: Could not open Employee_info.csv for saving credentials.";
+        setConsoleColor(7);
+    }
+
+    // Save account credentials to Account_info.csv
+    ofstream accFile("Account_info.csv");
+    if (accFile.is_open())
+    {
+        for (const auto &pair : accountCredentials)
+        {
+            accFile << pair.first << "," << pair.second << "\n";
+        }
+        accFile.close();
+    }
+    else
+    {
+        setConsoleColor(12);
+        cout << "\n\tError: Could not open Account_info.csv for saving credentials.";
+        setConsoleColor(7);
+    }
+}
+
+
+// --- Bank Class Member Functions Implementation ---
+
+bool Bank::openAccount(const string &acc_no, const string &name, const string &dob, const string &age,
+                       const string &address, const string &phone, const string &balance,
+                       const string &acc_type, const string &credential)
+{
+    if (accountCredentials.count(acc_no))
+        return false;
+    string creation_date_time = getCurrentDateTime();
+    accountCredentials[acc_no] = credential;
+    root = insert(root, {acc_no, name, dob, age, address, phone, balance, acc_type, creation_date_time, creation_date_time});
+    if (replicationLog != nullptr)
+        replicationLog->publish("O," + accountRecordLine(search(root, acc_no)) + "," + credential);
+    return true;
+}
+
+TxnStatus Bank::deposit(const string &acc_no, long long amount)
+{
+    if (amount <= 0)
+        return TxnStatus::InvalidAmount;
+    AccountNode *account = findAccount(acc_no);
+    if (account == nullptr)
+        return TxnStatus::NoSuchAccount;
+
+    account->balance = formatPaise(parseAmountToPaise(account->balance) + amount);
+    account->last_transaction = getCurrentDateTime();
+    commitVersions({account});
+
+    string transaction_description = "Deposit: +Rs " + formatPaise(amount) + " to " + acc_no;
+    transactionHistory.push_back(transaction_description);
+    recentTransactions.push(transaction_description);
+    recordTransaction("Deposit", acc_no, "", amount);
+    return TxnStatus::Ok;
+}
+
+TxnStatus Bank::withdraw(const string &acc_no, long long amount)
+{
+    if (amount <= 0)
+        return TxnStatus::InvalidAmount;
+    AccountNode *account = findAccount(acc_no);
+    if (account == nullptr)
+        return TxnStatus::NoSuchAccount;
+
+    long long current_balance = parseAmountToPaise(account->balance);
+    if (amount > current_balance)
+        return TxnStatus::InsufficientFunds;
+    if (velocityMonitor.admit(acc_no, amount, "", time(0)) != nullptr)
+        return TxnStatus::VelocityLimit;
+
+    account->balance = formatPaise(current_balance - amount);
+    account->last_transaction = getCurrentDateTime();
+    commitVersions({account});
+
+    string transaction_description = "Withdrawal: -Rs " + formatPaise(amount) + " from " + acc_no;
+    transactionHistory.push_back(transaction_description);
+    recentTransactions.push(transaction_description);
+    recordTransaction("Withdrawal", acc_no, "", amount);
+    return TxnStatus::Ok;
+}
+
+TxnStatus Bank::transfer(const string &from_acc_no, const string &to_acc_no, long long amount)
+{
+    AccountNode *from_account = findAccount(from_acc_no);
+    if (from_account == nullptr)
+        return TxnStatus::NoSuchAccount;
+    return transferBetween(from_account, findAccount(to_acc_no), from_acc_no, to_acc_no, amount);
+}
+
+TxnStatus Bank::transferBetween(AccountNode *from_account, AccountNode *to_account, const string &from_acc_no,
+                                const string &to_acc_no, long long amount)
+{
+    if (from_account == nullptr)
+        return TxnStatus::NoSuchAccount;
+    if (to_account == nullptr)
+        return TxnStatus::NoSuchRecipient;
+    if (from_acc_no == to_acc_no)
+        return TxnStatus::SameAccount;
+    if (amount <= 0)
+        return TxnStatus::InvalidAmount;
+
+    long long from_balance = parseAmountToPaise(from_account->balance);
+    if (amount > from_balance)
+        return TxnStatus::InsufficientFunds;
+    if (velocityMonitor.admit(from_acc_no, amount, to_acc_no, time(0)) != nullptr)
+        return TxnStatus::VelocityLimit;
+
+    from_account->balance = formatPaise(from_balance - amount);
+    to_account->balance = formatPaise(parseAmountToPaise(to_account->balance) + amount);
+
+    string transaction_time = getCurrentDateTime();
+    from_account->last_transaction = transaction_time;
+    to_account->last_transaction = transaction_time;
+    commitVersions({from_account, to_account}); // Both legs become visible together
+
+    string trans_sender = "Transfer Out: -Rs " + formatPaise(amount) + " to " + to_acc_no + " (From " + from_acc_no + ")";
+    string trans_receiver = "Transfer In: +Rs " + formatPaise(amount) + " from " + from_acc_no + " (To " + to_acc_no + ")";
+
+    transactionHistory.push_back(trans_sender);
+    transactionHistory.push_back(trans_receiver);
+    recentTransactions.push(trans_sender);
+    recentTransactions.push(trans_receiver);
+    recordTransaction("Transfer", from_acc_no, to_acc_no, amount);
+    return TxnStatus::Ok;
+}
+
+
+// Function to create a new customer account
+void Bank::createNewAccount()
+{
+    string account_number, name, dob, age, address, phone, deposit_amount_str, acc_type, password;
+    int choice_int;
+    bool accountExists;
+
+    do {
+        displayAppTitle();
+        cout << "\n\t\tACCOUNT CREATION\n";
+        cout << "\n\tEnter Account Number: ";
+        cin >> account_number;
+        while (const char *problem = accountFieldError(account_number))
+        {
+            if (!cin)
+                return;
+            setConsoleColor(12);
+            cout << "\n\tError: " << problem;
+            setConsoleColor(7);
+            cout << "\n\tEnter Account Number: ";
+            cin >> account_number;
+        }
+
+        accountExists = (accountCredentials.find(account_number) != accountCredentials.end());
+
+        if (accountExists)
+        {
+            setConsoleColor(12);
+            cout << "\n\tAccount No. " << account_number << " already exists!";
+            setConsoleColor(7);
+            cout << "\n\t1. Try a different Account Number\n\t2. Login To Existing Account\n\tChoice: ";
+            cin >> choice_int;
+            if (choice_int == 2) {
+                customerLogin(); // Go to customer login
+                return; // Exit this function
+            }
+        }
+    } while (accountExists && choice_int == 1); // Loop if account exists and user wants to try again
+
+    // Clear input buffer after reading account number
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    name = readAccountField("\n\tEnter Name: ");
+    dob = readAccountField("\n\tEnter Date of Birth (DD/MM/YYYY): "); // Changed format for clarity
+    age = readAccountField("\n\tEnter Age: ");
+    address = readAccountField("\n\tEnter Address (single line): ");
+    phone = readAccountField("\n\tEnter Phone Number: ");
+
+    cout << "\n\tWould you like to make an initial deposit?\n\t1. Yes\n\t2. No\n\tChoice: ";
+    cin >> choice_int;
+    if (choice_int == 1)
+    {
+        float depo_val;
+        cout << "\n\tEnter the amount to deposit: Rs ";
+        while (!(cin >> depo_val) || depo_val < 0) {
+            setConsoleColor(12);
+            cout << "\n\tInvalid amount. Please enter a non-negative number: Rs ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        deposit_amount_str = to_string(depo_val);
+    }
+    else
+    {
+        deposit_amount_str = "0.0"; // Initialize with 0.0 for consistency
+    }
+
+    cout << "\n\tSelect Type of Account:\n\t1. Saving\n\t2. Current\n\tChoice: ";
+    cin >> choice_int;
+    acc_type = (choice_int == 1) ? "Saving" : "Current";
+
+    cout << "\n\tEnter a Password for your Account: ";
+    password = getSecurePasswordInput();
+
+    // Add to in-memory credentials map and BST
+    if (!openAccount(account_number, name, dob, age, address, phone, deposit_amount_str, acc_type, hashPassword(password)))
+    {
+        setConsoleColor(12);
+        cout << "\n\tError: Account No. " << account_number << " already exists!";
+        setConsoleColor(7);
+        cout << "\n\n\tPress any key to return to Main Menu...";
+        readKey();
+        main();
+        return;
+    }
+
+    // Save all changes to files
+    saveAllCredentials(); // Save updated account credentials
+    saveAccountsToFile(); // Save updated bank records
+
+    setConsoleColor(10); // Green color
+    cout << "\n\tAccount created successfully!";
+    cout << "\n\tAccount Number: " << account_number;
+    cout << "\n\tInitial Balance: Rs " << deposit_amount_str;
+    setConsoleColor(7);
+
+    cout << "\n\n\tPress any key to return to Main Menu...";
+    readKey();
+    main(); // Return to main menu
+}
+
+
+void Bank::modifyAccountDetails()
+{
+    displayAppTitle();
+    cout << "\n\t\tACCOUNT MODIFICATION\n";
+
+    string acc_no;
+    cout << "\n\tEnter the Account Number to modify: ";
+    cin >> acc_no;
+
+    AccountNode *account = findAccount(acc_no);
+    if (account == nullptr)
+    {
+        setConsoleColor(12);
+        cout << "\n\tAccount Doesn't Exist!";
+        setConsoleColor(7);
+    }
+    else
+    {
+        setConsoleColor(11); // Cyan
+        cout << "\n\tAccount Found! Current Details:";
+        setConsoleColor(7); // White
+        cout << "\n\tAccount NO.: " << account->account_number;
+        cout << "\n\tName: " << account->name;
+        cout << "\n\tDOB: " << account->dob;
+        cout << "\n\tAge: " << account->age;
+        cout << "\n\tAddress: " << account->address;
+        cout << "\n\tPhone number: " << account->phone;
+        cout << "\n\tType Of Account: " << account->acc_type;
+        cout << "\n\tDate of Account creation: " << account->creation_date;
+        cout << "\n\tAmount deposited: Rs " << account->balance;
+        cout << "\n\tLast Transaction: " << account->last_transaction;
+
+        int choice;
+        string newValue;
+        do
+        {
+            cout << "\n\n\tWhat would you like to update?";
+            cout << "\n\t1. Name";
+            cout << "\n\t2. Date of Birth";
+            cout << "\n\t3. Age";
+            cout << "\n\t4. Address";
+            cout << "\n\t5. Phone Number";
+            cout << "\n\t6. Change Account Password"; // New option
+            cout << "\n\t7. Done Updating"; // Changed from 6 to 7
+            cout << "\n\tChoice: ";
+            cin >> choice;
+            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Clear buffer for getline
+
+            switch (choice)
+            {
+            case 1:
+                cout << "\n\tEnter New Name: ";
+                getline(cin, newValue);
+                unindexProfile(account);
+                account->name = newValue;
+                indexProfile(account);
+                setConsoleColor(10); cout << "\n\tName updated successfully."; setConsoleColor(7);
+                break;
+            case 2:
+                cout << "\n\tEnter New Date of Birth (DD/MM/YYYY): ";
+                getline(cin, newValue);
+                unindexProfile(account);
+                account->dob = newValue;
+                indexProfile(account);
+                setConsoleColor(10); cout << "\n\tDate of Birth updated successfully."; setConsoleColor(7);
+                break;
+            case 3:
+                cout << "\n\tEnter New Age: ";
+                cin >> newValue;
+                account->age = newValue;
+                setConsoleColor(10); cout << "\n\tAge updated successfully."; setConsoleColor(7);
+                break;
+            case 4:
+                cout << "\n\tEnter New Address: ";
+                getline(cin, newValue);
+                account->address = newValue;
+                setConsoleColor(10); cout << "\n\tAddress updated successfully."; setConsoleColor(7);
+                break;
+            case 5:
+                cout << "\n\tEnter New Phone Number: ";
+                cin >> newValue;
+                unindexProfile(account);
+                account->phone = newValue;
+                indexProfile(account);
+                setConsoleColor(10); cout << "\n\tPhone Number updated successfully."; setConsoleColor(7);
+                break;
+            case 6:
+                cout << "\n\tEnter New Password: ";
+                newValue = getSecurePasswordInput();
+                accountCredentials[acc_no] = hashPassword(newValue); // Update in credentials map
+                saveAllCredentials(); // Save updated credentials
+                setConsoleColor(10); cout << "\n\tPassword updated successfully."; setConsoleColor(7);
+                break;
+            case 7:
+                setConsoleColor(10);
+                cout << "\n\tFinishing updates...";
+                setConsoleColor(7);
+                break;
+            default:
+                setConsoleColor(12);
+                cout << "\n\tInvalid Choice! Please try again.";
+                setConsoleColor(7);
+                break;
+            }
+            if (choice != 7) {
+                cout << "\n\n\tPress any key to continue modifications...";
+                readKey();
+                displayAppTitle();
+                cout << "\n\t\tACCOUNT MODIFICATION\n";
+            }
+        } while (choice != 7);
+
+        saveAccountsToFile(); // Save updated account details to Bank_Record.csv
+        setConsoleColor(10);
+        cout << "\n\tAccount details saved successfully!";
+        setConsoleColor(7);
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    showCustomerMenu(); // Assume customer is logged in, or route to main menu if called by employee
+}
+
+
+void Bank::searchAccountRecord()
+{
+    displayAppTitle();
+    cout << "\n\t\tACCOUNT SEARCH\n";
+
+    int search_type_choice;
+    cout << "\n\tSearch by:\n\t1. Account Number\n\t2. Name\n\t3. Phone Number\n\t4. Date of Birth and Name"
+         << "\n\t5. Account Number Prefix\n\tChoice: ";
+    while (!(cin >> search_type_choice) || (search_type_choice < 1 || search_type_choice > 5)) {
+        setConsoleColor(12);
+        cout << "\n\tInvalid choice. Please enter 1 to 5: ";
+        setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Clear buffer
+
+    if (search_type_choice == 1)
+    {
+        string acc_no;
+        cout << "\n\tEnter Account Number to search: ";
+        cin >> acc_no;
+
+        AccountNode *account = findAccount(acc_no);
+        if (account == nullptr)
+        {
+            setConsoleColor(12);
+            cout << "\n\tAccount Doesn't Exist!";
+            setConsoleColor(7);
+        }
+        else
+        {
+            setConsoleColor(11);
+            cout << "\n\tAccount Details Found:";
+            setConsoleColor(7);
+            cout << "\n\tAccount NO.: " << account->account_number;
+            cout << "\n\tName: " << account->name;
+            cout << "\n\tDOB: " << account->dob;
+            cout << "\n\tAge: " << account->age;
+            cout << "\n\tAddress: " << account->address;
+            cout << "\n\tPhone number: " << account->phone;
+            cout << "\n\tType Of Account: " << account->acc_type;
+            cout << "\n\tDate of Account creation: " << account->creation_date;
+            cout << "\n\tBalance: Rs " << account->balance;
+            cout << "\n\tLast Transaction: " << account->last_transaction;
+        }
+    }
+    else if (search_type_choice == 2)
+    {
+        string name_search;
+        cout << "\n\tEnter Name (or part of name) to search: ";
+        getline(cin, name_search);
+
+        bool found = false;
+        // Lambda function for in-order traversal to search by name
+        function<void(AccountNode *)> searchByNameTraversal = [&](AccountNode *node)
+        {
+            if (node == nullptr)
+                return;
+
+            searchByNameTraversal(node->left);
+
+            // Case-insensitive search for name
+            string node_name_lower = node->name;
+            string search_name_lower = name_search;
+            transform(node_name_lower.begin(), node_name_lower.end(), node_name_lower.begin(), ::tolower);
+            transform(search_name_lower.begin(), search_name_lower.end(), search_name_lower.begin(), ::tolower);
+
+            if (node_name_lower.find(search_name_lower) != string::npos)
+            {
+                if (!found)
+                {
+                    setConsoleColor(11);
+                    cout << "\n\tAccounts Found (matching '" << name_search << "'):";
+                    setConsoleColor(7);
+                    found = true;
+                }
+
+                cout << "\n\n\tAccount NO.: " << node->account_number;
+                cout << "\n\tName: " << node->name;
+                cout << "\n\tType Of Account: " << node->acc_type;
+                cout << "\n\tBalance: Rs " << node->balance;
+                cout << "\n\tLast Transaction: " << node->last_transaction;
+                cout << "\n\t---------------------------";
+            }
+
+            searchByNameTraversal(node->right);
+        };
+
+        searchByNameTraversal(root);
+
+        if (!found)
+        {
+            setConsoleColor(12);
+            cout << "\n\tNo accounts with that name (or matching part) were found!";
+            setConsoleColor(7);
+        }
+    }
+    else if (search_type_choice == 5)
+    {
+        const size_t SHOWN = 20;
+        string prefix;
+        cout << "\n\tEnter the first digits of the Account Number: ";
+        getline(cin, prefix);
+
+        vector<AccountNode *> matches;
+        accountTrie.findPrefix(prefix, SHOWN + 1, matches); // One extra tells us whether there are more
+        if (matches.empty())
+        {
+            setConsoleColor(12);
+            cout << "\n\tNo account numbers start with " << prefix << "!";
+            setConsoleColor(7);
+        }
+        else
+        {
+            setConsoleColor(11);
+            cout << "\n\tAccounts starting with " << prefix << ":\n";
+            setConsoleColor(7);
+            listingBuffer.clear();
+            for (size_t i = 0; i < matches.size() && i < SHOWN; i++)
+                appendAccountRow(listingBuffer, matches[i]);
+            cout << listingBuffer;
+            if (matches.size() > SHOWN)
+                cout << "\n\t(First " << SHOWN << " shown, type more digits to narrow the search)";
+        }
+    }
+    else
+    {
+        // Exact lookups through the secondary indexes
+        vector<AccountNode *> matches;
+        string described;
+        if (search_type_choice == 3)
+        {
+            string phone;
+            cout << "\n\tEnter Phone Number to search: ";
+            getline(cin, phone);
+            matches = lookupIndex(phoneIndex, phoneKey(phone));
+            described = "phone " + phone;
+        }
+        else
+        {
+            string dob, name;
+            cout << "\n\tEnter Date of Birth (DD/MM/YYYY): ";
+            getline(cin, dob);
+            cout << "\n\tEnter Full Name: ";
+            getline(cin, name);
+            matches = lookupIndex(profileIndex, profileKey(dob, name));
+            described = name + ", born " + dob;
+        }
+
+        if (matches.empty())
+        {
+            setConsoleColor(12);
+            cout << "\n\tNo accounts found for " << described << "!";
+            setConsoleColor(7);
+        }
+        else
+        {
+            setConsoleColor(11);
+            cout << "\n\tAccounts Found (" << described << "):";
+            setConsoleColor(7);
+            for (const AccountNode *node : matches)
+            {
+                cout << "\n\n\tAccount NO.: " << node->account_number;
+                cout << "\n\tName: " << node->name;
+                cout << "\n\tPhone number: " << node->phone;
+                cout << "\n\tType Of Account: " << node->acc_type;
+                cout << "\n\tBalance: Rs " << node->balance;
+                cout << "\n\tLast Transaction: " << node->last_transaction;
+                cout << "\n\t---------------------------";
+            }
+        }
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    // Decide which menu to return to based on context (e.g., employee or customer)
+    // For simplicity, let's assume this is called from customer menu, or main menu for employee
+    // You might want to pass a flag to this function to decide where to return
+    if (cin.peek() == EOF) { // Simple check if EOF implies called from employee context
+         showEmployeeMenu();
+    } else {
+        showCustomerMenu();
+    }
+}
+
+
+void Bank::handleDepositWithdrawal()
+{
+    displayAppTitle();
+    cout << "\n\t\tTRANSACTIONS\n";
+
+    string acc_no;
+    cout << "\n\tEnter Account Number: ";
+    cin >> acc_no;
+
+    AccountNode *account = findAccount(acc_no);
+    if (account == nullptr)
+    {
+        setConsoleColor(12);
+        cout << "\n\tAccount Doesn't Exist!";
+        setConsoleColor(7);
+    }
+    else
+    {
+        setConsoleColor(11);
+        cout << "\n\tAccount Details:";
+        setConsoleColor(7);
+        cout << "\n\tAccount NO.: " << account->account_number;
+        cout << "\n\tName: " << account->name;
+        cout << "\n\tCurrent Balance: Rs " << account->balance;
+
+        int transaction_type_choice;
+        cout << "\n\n\t1. Deposit\n\t2. Withdraw\n\tChoice: ";
+        while (!(cin >> transaction_type_choice) || (transaction_type_choice < 1 || transaction_type_choice > 2)) {
+            setConsoleColor(12);
+            cout << "\n\tInvalid choice. Please enter 1 or 2: ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+
+        float amount;
+        cout << "\n\tEnter Amount: Rs ";
+        while (!(cin >> amount) || amount <= 0) { // Validate positive amount
+            setConsoleColor(12);
+            cout << "\n\tInvalid amount. Please enter a positive number: Rs ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+
+        long long amount_paise = llround(amount * 100.0);
+        TxnStatus status = (transaction_type_choice == 1) ? deposit(acc_no, amount_paise) : withdraw(acc_no, amount_paise);
+
+        if (status == TxnStatus::Ok)
+        {
+            setConsoleColor(10);
+            cout << (transaction_type_choice == 1 ? "\n\tDeposit Successful!" : "\n\tWithdrawal Successful!");
+            setConsoleColor(7);
+            saveAccountsToFile(); // Save updated balance and last transaction date
+            cout << "\n\tNew Balance: Rs " << account->balance;
+        }
+        else
+        {
+            setConsoleColor(12);
+            cout << "\n\t" << txnStatusMessage(status);
+            setConsoleColor(7);
+        }
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    showCustomerMenu();
+}
+
+
+void Bank::displayAllAccounts()
+{
+    size_t page_size = LISTING_PAGE_SIZE;
+    vector<AccountNode *> page;
+    collectForward("", true, page_size, page); // Cursor starts at the first account
+
+    while (true)
+    {
+        displayAppTitle();
+        cout << "\n\t\tALL ACCOUNT HOLDERS\n";
+
+        if (root == nullptr) {
+            setConsoleColor(12);
+            cout << "\n\tNo accounts to display.";
+            setConsoleColor(7);
+            break;
+        }
+
+        setConsoleColor(14); // Yellow
+        cout << left
+             << "\n\t" << setw(20) << "Account No."
+             << setw(30) << "Name"
+             << setw(20) << "Type"
+             << setw(15) << "Balance" << "\n";
+        cout << "\t" << string(85, '-') << "\n";
+        setConsoleColor(7); // White
+
+        // Format the whole page into one buffer and write it in a single call
+        listingBuffer.clear();
+        for (const AccountNode *node : page)
+        {
+            appendAccountRow(listingBuffer, node);
+        }
+        listingBuffer.append("\n\t").append(to_string(page.size())).append(" account(s) on this page, page size ");
+        listingBuffer.append(to_string(page_size));
+        listingBuffer.append("\n\n\t[N] Next  [P] Previous  [J] Jump to Account No.  [S] Page Size  [E] Export to File  [Q] Return");
+        listingBuffer.append("\n\tChoice: ");
+        cout.write(listingBuffer.data(), static_cast<streamsize>(listingBuffer.size()));
+        cout.flush();
+
+        vector<AccountNode *> next_page;
+        char key = static_cast<char>(toupper(readKey()));
+        if (key == 'Q')
+        {
+            break;
+        }
+        else if (key == 'N' && !page.empty())
+        {
+            collectForward(page.back()->account_number, false, page_size, next_page);
+            if (!next_page.empty())
+                page.swap(next_page); // Stay on the last page when there is nothing further
+        }
+        else if (key == 'P' && !page.empty())
+        {
+            collectBackward(page.front()->account_number, page_size, next_page);
+            if (!next_page.empty())
+                page.swap(next_page);
+        }
+        else if (key == 'J')
+        {
+            string acc_no;
+            cout << "\n\tEnter Account Number (or leading digits) to jump to: ";
+            cin >> acc_no;
+            collectForward(acc_no, true, page_size, next_page);
+            if (next_page.empty())
+                collectBackward(acc_no, page_size, next_page); // Past the end, show the last page
+            page.swap(next_page);
+        }
+        else if (key == 'S')
+        {
+            size_t new_size;
+            cout << "\n\tEnter rows per page: ";
+            while (!(cin >> new_size) || new_size == 0) {
+                setConsoleColor(12);
+                cout << "\n\tInvalid page size. Please enter a positive number: ";
+                setConsoleColor(7);
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            }
+            page_size = new_size;
+            collectForward(page.empty() ? string() : page.front()->account_number, true, page_size, next_page);
+            page.swap(next_page);
+        }
+        else if (key == 'E')
+        {
+            size_t written = exportAccountListing("Account_Listing.txt");
+            setConsoleColor(10);
+            cout << "\n\n\t" << written << " account(s) exported to Account_Listing.txt";
+            setConsoleColor(7);
+            cout << "\n\n\tPress any key to continue...";
+            readKey();
+        }
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    showEmployeeMenu(); // Return to employee menu
+}
+
+
+// Streams every account in account-number order to a file. Rows are formatted into the
+// reusable buffer and flushed in large blocks instead of one stream operation per field.
+size_t Bank::exportAccountListing(const string &filename)
+{
+    ofstream file(filename, ios::binary);
+    if (!file.is_open())
+    {
+        setConsoleColor(12);
+        cout << "\n\tError: Could not open " << filename << " for export.";
+        setConsoleColor(7);
+        return 0;
+    }
+
+    listingBuffer.clear();
+    listingBuffer.append("\tAccount No.         Name                          Type                Balance\n");
+
+    size_t written = 0;
+    vector<AccountNode *> path;
+    for (AccountNode *node = root; node != nullptr; node = node->left)
+        path.push_back(node);
+    while (!path.empty())
+    {
+        AccountNode *current = path.back();
+        path.pop_back();
+        appendAccountRow(listingBuffer, current);
+        written++;
+        if (listingBuffer.size() >= EXPORT_FLUSH_BYTES)
+        {
+            file.write(listingBuffer.data(), listingBuffer.size());
+            listingBuffer.clear();
+        }
+        for (AccountNode *node = current->right; node != nullptr; node = node->left)
+            path.push_back(node);
+    }
+    file.write(listingBuffer.data(), listingBuffer.size());
+    listingBuffer.clear();
+    file.close();
+    return written;
+}
+
+
+void Bank::performFundTransfer()
+{
+    displayAppTitle();
+    cout << "\n\t\tFUND TRANSFER\n";
+
+    string from_acc_no, to_acc_no;
+    float amount;
+
+    cout << "\n\tEnter Your Account Number (Sender): ";
+    cin >> from_acc_no;
+
+    AccountNode *from_account = findAccount(from_acc_no);
+    if (from_account == nullptr)
+    {
+        setConsoleColor(12);
+        cout << "\n\tSender Account Doesn't Exist!";
+        setConsoleColor(7);
+        cout << "\n\n\tPress any key to return to menu...";
+        readKey();
+        showCustomerMenu();
+        return;
+    }
+
+    cout << "\n\tEnter Recipient Account Number: ";
+    cin >> to_acc_no;
+
+    AccountNode *to_account = findAccount(to_acc_no);
+    if (to_account == nullptr)
+    {
+        setConsoleColor(12);
+        cout << "\n\tRecipient Account Doesn't Exist!";
+        setConsoleColor(7);
+        cout << "\n\n\tPress any key to return to menu...";
+        readKey();
+        showCustomerMenu();
+        return;
+    }
+
+    // Prevent transferring to the same account
+    if (from_acc_no == to_acc_no) {
+        setConsoleColor(12);
+        cout << "\n\tCannot transfer to the same account!";
+        setConsoleColor(7);
+        cout << "\n\n\tPress any key to return to menu...";
+        readKey();
+        showCustomerMenu();
+        return;
+    }
+
+
+    cout << "\n\tEnter Amount to Transfer: Rs ";
+    while (!(cin >> amount) || amount <= 0) {
+        setConsoleColor(12);
+        cout << "\n\tInvalid amount. Please enter a positive number: Rs ";
+        setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    TxnStatus status = transfer(from_acc_no, to_acc_no, llround(amount * 100.0));
+    if (status == TxnStatus::InsufficientFunds)
+    {
+        setConsoleColor(12);
+        cout << "\n\tInsufficient Balance in Sender Account!";
+        setConsoleColor(7);
+    }
+    else if (status != TxnStatus::Ok)
+    {
+        setConsoleColor(12);
+        cout << "\n\t" << txnStatusMessage(status);
+        setConsoleColor(7);
+    }
+    else
+    {
+        saveAccountsToFile(); // Save updated balances and last transaction dates
+
+        setConsoleColor(10);
+        cout << "\n\tTransfer Successful!";
+        cout << "\n\tYour New Balance (Sender): Rs " << from_account->balance;
+        setConsoleColor(7);
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    showCustomerMenu();
+}
+
+
+void Bank::viewTransactionHistory()
+{
+    displayAppTitle();
+    cout << "\n\t\tTRANSACTION HISTORY\n";
+
+    if (recentTransactions.empty()) // Use recentTransactions for user display
+    {
+        setConsoleColor(12);
+        cout << "\n\tNo recent transactions to display.";
+        setConsoleColor(7);
+    }
+    else
+    {
+        setConsoleColor(14);
+        cout << "\n\tLast 10 Recent Transactions (newest first):";
+        setConsoleColor(7);
+        cout << "\n\t--------------------------------------------------\n";
+
+        stack<string> tempStack = recentTransactions; // Use a temporary stack
+        int count = 0;
+
+        while (!tempStack.empty() && count < 10) // Display up to 10
+        {
+            cout << "\t" << tempStack.top() << "\n";
+            tempStack.pop();
+            count++;
+        }
+        if (recentTransactions.size() > 10) {
+            cout << "\n\t(More transactions available, showing last 10)";
+        }
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    showCustomerMenu();
+}
+
+
+void Bank::submitServiceRequest()
+{
+    displayAppTitle();
+    cout << "\n\t\tREQUEST CUSTOMER SERVICE\n";
+
+    string acc_no, request_description;
+    cout << "\n\tEnter Your Account Number: ";
+    cin >> acc_no;
+
+    AccountNode *account = findAccount(acc_no);
+    if (account == nullptr)
+    {
+        setConsoleColor(12);
+        cout << "\n\tAccount Doesn't Exist!";
+        setConsoleColor(7);
+    }
+    else
+    {
+        int service_choice;
+        cout << "\n\tSelect service type:";
+        cout << "\n\t1. Technical Issue";
+        cout << "\n\t2. Account Query";
+        cout << "\n\t3. Loan Information";
+        cout << "\n\t4. Other";
+        cout << "\n\tChoice: ";
+        while (!(cin >> service_choice) || (service_choice < 1 || service_choice > 4)) {
+            setConsoleColor(12);
+            cout << "\n\tInvalid choice. Please enter a number between 1 and 4: ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Clear buffer before getline
+
+        string service_type_str = serviceTypeName(service_choice);
+
+        cout << "\n\tPlease describe your request (single line): ";
+        getline(cin, request_description);
+
+        string service_request_string = getCurrentDateTime() + " | Account: " + acc_no + " | Name: " + account->name + " | Type: " + service_type_str + " | Desc: " + request_description;
+        string assigned_to;
+        size_t position = serviceDesk.submit(service_choice, service_request_string, assigned_to);
+
+        setConsoleColor(10);
+        cout << "\n\tYour service request has been queued!";
+        cout << "\n\tCurrent queue position: " << position;
+        cout << (assigned_to.empty() ? "\n\tIt will be picked up by the next available employee." : "\n\tAssigned to: " + assigned_to);
+        setConsoleColor(7);
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    showCustomerMenu();
+}
+
+
+void Bank::manageServiceQueue()
+{
+    displayAppTitle();
+    cout << "\n\t\tSERVICE QUEUE MANAGEMENT\n";
+
+    int desk = serviceDesk.deskOf(currentEmployee);
+    int specialty = serviceDesk.specialty(desk);
+    setConsoleColor(14);
+    cout << "\n\tPending Service Requests: " << serviceDesk.pending();
+    setConsoleColor(7);
+    cout << "\n\tYour queue (" << currentEmployee << ", " << (specialty == 0 ? string("all types") : serviceTypeName(specialty))
+         << "): " << serviceDesk.pending(desk);
+    cout << "\n\t--------------------------------------------------\n";
+    string next = serviceDesk.peek(desk);
+    if (next.empty() && serviceDesk.pending() > 0)
+        cout << "\n\tNext in queue: (taken from a colleague's queue)";
+    else if (!next.empty())
+        cout << "\n\tNext in queue: " << next;
+
+    int queue_action_choice;
+    cout << "\n\n\tWhat would you like to do?";
+    cout << "\n\t1. Process Next Request";
+    cout << "\n\t2. View All Requests in Queue";
+    cout << "\n\t3. Set My Request Type Specialty";
+    cout << "\n\t4. Service Time Metrics";
+    cout << "\n\t5. Dispatcher Benchmark";
+    cout << "\n\t6. Return to Employee Menu";
+    cout << "\n\tChoice: ";
+    while (!(cin >> queue_action_choice) || (queue_action_choice < 1 || queue_action_choice > 6)) {
+        setConsoleColor(12);
+        cout << "\n\tInvalid choice. Please enter a number between 1 and 6: ";
+        setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    if (queue_action_choice == 1)
+    {
+        ServiceTicket ticket;
+        string taken_from;
+        if (!serviceDesk.take(desk, ticket, taken_from))
+        {
+            setConsoleColor(12);
+            cout << "\n\tNo pending service requests.";
+            setConsoleColor(7);
+        }
+        else
+        {
+            cout << "\n\tProcessing request: " << ticket.text;
+            if (!taken_from.empty())
+                cout << "\n\t(Taken from " << taken_from << "'s queue)";
+            cout << "\n\n\tPress any key once the request is resolved...";
+            readKey();
+            serviceDesk.complete(desk, ticket);
+            setConsoleColor(10);
+            cout << "\n\tRequest processed successfully!";
+            setConsoleColor(7);
+            cout << "\n\tRemaining requests: " << serviceDesk.pending();
+        }
+        cout << "\n\n\tPress any key to continue...";
+        readKey();
+        manageServiceQueue(); // Recurse to process more or return
+    }
+    else if (queue_action_choice == 2)
+    {
+        cout << "\n\n\tAll pending requests:";
+        for (const ServiceDesk::DeskStatus &desk : serviceDesk.status())
+        {
+            if (desk.tickets.empty() && !desk.on_duty)
+                continue;
+            setConsoleColor(14);
+            cout << "\n\n\t" << desk.employee << (desk.on_duty ? "" : " (off duty)") << ": " << desk.tickets.size() << " pending";
+            setConsoleColor(7);
+            int count = 1;
+            for (const string &text : desk.tickets)
+                cout << "\n\t" << count++ << ". " << text;
+        }
+        cout << "\n\n\tPress any key to return...";
+        readKey();
+        manageServiceQueue(); // Return to queue options
+    }
+    else if (queue_action_choice == 3)
+    {
+        cout << "\n\tRequest type you handle first:";
+        for (int type = 1; type <= SERVICE_TYPES; type++)
+            cout << "\n\t" << type << ". " << serviceTypeName(type);
+        cout << "\n\t0. All types";
+        cout << "\n\tChoice: ";
+        while (!(cin >> specialty) || specialty < 0 || specialty > SERVICE_TYPES) {
+            setConsoleColor(12);
+            cout << "\n\tInvalid choice. Please enter a number between 0 and " << SERVICE_TYPES << ": ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        serviceDesk.setSpecialty(desk, specialty);
+        setConsoleColor(10);
+        cout << "\n\tNew requests of this type will be routed to you first.";
+        setConsoleColor(7);
+        cout << "\n\n\tPress any key to continue...";
+        readKey();
+        manageServiceQueue();
+    }
+    else if (queue_action_choice == 4)
+    {
+        cout << "\n\n\t" << left << setw(20) << "Type" << setw(8) << "Count" << setw(30) << "Wait p50/p90/p99 (s)" << "Handle p50/p90/p99 (s)";
+        cout << fixed << setprecision(1);
+        for (int type = 0; type <= SERVICE_TYPES; type++)
+        {
+            ServicePercentiles wait, handle;
+            serviceDesk.percentiles(type, wait, handle);
+            ostringstream wait_text, handle_text;
+            wait_text << fixed << setprecision(1) << wait.p50 / 1e6 << " / " << wait.p90 / 1e6 << " / " << wait.p99 / 1e6;
+            handle_text << fixed << setprecision(1) << handle.p50 / 1e6 << " / " << handle.p90 / 1e6 << " / " << handle.p99 / 1e6;
+            cout << "\n\t" << setw(20) << (type == 0 ? string("All") : serviceTypeName(type)) << setw(8) << wait.count
+                 << setw(30) << wait_text.str() << handle_text.str();
+        }
+        cout << "\n\n\t" << setw(20) << "Employee" << setw(10) << "Pending" << setw(10) << "Handled" << "Stolen";
+        for (const ServiceDesk::DeskStatus &desk : serviceDesk.status())
+            cout << "\n\t" << setw(20) << desk.employee << setw(10) << desk.tickets.size() << setw(10) << desk.handled << desk.stolen;
+        cout << defaultfloat << setprecision(6) << right;
+        cout << "\n\n\tPress any key to return...";
+        readKey();
+        manageServiceQueue();
+    }
+    else if (queue_action_choice == 5)
+    {
+        runServiceDeskBenchmark();
+        manageServiceQueue();
+    }
+
+    showEmployeeMenu(); // Always return to employee menu from here
+}
+
+
+// Dispatcher throughput with S staff threads working through tickets filed by two customer
+// threads, against one shared queue behind one lock (the old serviceQueue model). Handling a
+// ticket costs a few microseconds of work so lock hold times, not handling, dominate both runs.
+void runServiceDeskBenchmark()
+{
+    displayAppTitle();
+    cout << "\n\t\tSERVICE DESK BENCHMARK\n";
+
+    const size_t TICKETS = 200000;
+    const int FILERS = 2;
+    auto handleTicket = [](const string &text)
+    {
+        unsigned long long h = 1469598103934665603ULL; // A few microseconds of "work" per ticket
+        for (int round = 0; round < 16; round++)
+            for (char c : text)
+                h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        return h;
+    };
+
+    // Runs one configuration; file(i) files ticket i, work() handles one ticket or returns false
+    auto run = [&](int staff, auto &&file, auto &&work)
+    {
+        atomic<size_t> filed{0}, handled{0};
+        atomic<unsigned long long> checksum{0};
+        auto started = chrono::steady_clock::now();
+        vector<thread> threads;
+        for (int f = 0; f < FILERS; f++)
+        {
+            threads.emplace_back([&]()
+            {
+                size_t i;
+                while ((i = filed++) < TICKETS)
+                    file(i);
+            });
+        }
+        for (int s = 0; s < staff; s++)
+        {
+            threads.emplace_back([&, s]()
+            {
+                unsigned long long local = 0;
+                while (handled < TICKETS)
+                {
+                    if (work(s, local))
+                        handled++;
+                    else
+                        this_thread::yield();
+                }
+                checksum += local;
+            });
+        }
+        for (thread &t : threads)
+            t.join();
+        return TICKETS / chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    };
+    auto ticketText = [](size_t i) { return "Mon Jan 01 10:00:00 2026 | Account: " + to_string(1000000000 + i) + " | Type: Account Query | Desc: benchmark"; };
+
+    cout << "\n\tTickets per run: " << TICKETS << ", filed by " << FILERS << " threads";
+    cout << "\n\n\t" << left << setw(8) << "Staff" << setw(22) << "Single queue/s" << "Service desk/s";
+    cout << fixed << setprecision(0);
+    for (int staff : {1, 2, 4, 8, 16, 32})
+    {
+        mutex single_lock;
+        deque<string> single_queue;
+        double single = run(
+            staff, [&](size_t i)
+            {
+                string text = ticketText(i);
+                lock_guard<mutex> guard(single_lock);
+                single_queue.push_back(move(text));
+            },
+            [&](int, unsigned long long &local)
+            {
+                string text;
+                {
+                    lock_guard<mutex> guard(single_lock);
+                    if (single_queue.empty())
+                        return false;
+                    text = move(single_queue.front());
+                    single_queue.pop_front();
+                }
+                local += handleTicket(text);
+                return true;
+            });
+
+        ServiceDesk desk;
+        for (int s = 0; s < staff; s++)
+            desk.setSpecialty(desk.openDesk("staff" + to_string(s)), s % (SERVICE_TYPES + 1));
+        double dispatched = run(
+            staff, [&](size_t i)
+            {
+                string assigned_to;
+                desk.submit(static_cast<int>(i % SERVICE_TYPES) + 1, ticketText(i), assigned_to);
+            },
+            [&](int s, unsigned long long &local)
+            {
+                ServiceTicket ticket;
+                string taken_from;
+                if (!desk.take(s, ticket, taken_from)) // Desks were opened in staff order
+                    return false;
+                local += handleTicket(ticket.text);
+                desk.complete(s, ticket);
+                return true;
+            });
+        cout << "\n\t" << setw(8) << staff << setw(22) << single << dispatched;
+    }
+    cout << defaultfloat << setprecision(6) << right;
+    cout << "\n\n\tCores: " << thread::hardware_concurrency();
+    cout << "\n\n\tPress any key to return...";
+    readKey();
+}
+
+
+// Computes the dashboard aggregates. Accounts and ledger entries are split into contiguous chunks,
+// each worker reduces its chunk into a private partial report, and the partials are merged at the end.
+// Balances are read from one pinned snapshot, so totals are consistent even while transfers commit.
+AnalyticsReport Bank::computeAnalytics()
+{
+    Snapshot snapshot(versionRegistry);
+    const size_t account_count = accountDirectory.size();
+    const long long today = time(0) / 86400;
+
+    size_t workers = parallelWorkerCount(account_count);
+    vector<AnalyticsReport> partials(workers);
+    runParallelChunks(account_count, workers, [&](size_t begin, size_t end, size_t chunk)
+    {
+        AnalyticsReport &part = partials[chunk];
+        for (size_t i = begin; i < end; i++)
+        {
+            const AccountNode *node = accountDirectory[i];
+            const BalanceVersion *version = snapshot.read(node);
+            if (version == nullptr)
+                continue; // Opened after the snapshot
+            long long balance = version->balance;
+            part.accounts++;
+            part.total_deposits += balance;
+
+            int bucket = 0;
+            for (long long limit = 100000; bucket < BALANCE_BUCKETS - 1 && balance >= limit; limit *= 10)
+                bucket++; // Bucket edges at Rs 1K, 10K, 100K, 1M, 10M
+            part.balance_histogram[bucket]++;
+
+            AccountTypeStats &type_stats = part.by_type[node->acc_type];
+            type_stats.count++;
+            type_stats.total += balance;
+            type_stats.min_balance = min(type_stats.min_balance, balance);
+            type_stats.max_balance = max(type_stats.max_balance, balance);
+
+            long long created = parseDateToDays(node->creation_date);
+            if (created >= 0)
+            {
+                long long age_days = today - created;
+                int cohort = age_days < 30 ? 0 : age_days < 182 ? 1 : age_days < 365 ? 2 : age_days < 3 * 365 ? 3 : 4;
+                part.age_cohorts[cohort]++;
+            }
+        }
+    });
+
+    size_t ledger_workers = parallelWorkerCount(transactionLedger.size());
+    vector<map<long long, DailyVolume>> daily_partials(ledger_workers);
+    runParallelChunks(transactionLedger.size(), ledger_workers, [&](size_t begin, size_t end, size_t chunk)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            DailyVolume &day = daily_partials[chunk][transactionLedger[i].timestamp / 86400];
+            day.count++;
+            day.total += transactionLedger[i].amount;
+        }
+    });
+
+    AnalyticsReport report;
+    for (const AnalyticsReport &part : partials)
+    {
+        report.accounts += part.accounts;
+        report.total_deposits += part.total_deposits;
+        for (int b = 0; b < BALANCE_BUCKETS; b++)
+            report.balance_histogram[b] += part.balance_histogram[b];
+        for (int c = 0; c < AGE_COHORTS; c++)
+            report.age_cohorts[c] += part.age_cohorts[c];
+        for (const auto &pair : part.by_type)
+        {
+            AccountTypeStats &merged = report.by_type[pair.first];
+            merged.count += pair.second.count;
+            merged.total += pair.second.total;
+            merged.min_balance = min(merged.min_balance, pair.second.min_balance);
+            merged.max_balance = max(merged.max_balance, pair.second.max_balance);
+        }
+    }
+    for (const auto &days : daily_partials)
+    {
+        for (const auto &pair : days)
+        {
+            report.daily_volume[pair.first].count += pair.second.count;
+            report.daily_volume[pair.first].total += pair.second.total;
+        }
+    }
+    return report;
+}
+
+
+void Bank::showAnalyticsDashboard()
+{
+    displayAppTitle();
+    cout << "\n\t\tANALYTICS DASHBOARD\n";
+
+    auto started = chrono::steady_clock::now();
+    AnalyticsReport report = computeAnalytics();
+    auto elapsed_ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started).count();
+
+    setConsoleColor(14);
+    cout << "\n\tOverview";
+    setConsoleColor(7);
+    cout << "\n\tTotal Accounts: " << report.accounts;
+    cout << "\n\tTotal Deposits: Rs " << formatPaise(report.total_deposits);
+    cout << "\n\tLedger Entries: " << transactionLedger.size();
+
+    setConsoleColor(14);
+    cout << "\n\n\tBy Account Type";
+    setConsoleColor(7);
+    for (const auto &pair : report.by_type)
+    {
+        const AccountTypeStats &stats = pair.second;
+        cout << "\n\t" << left << setw(10) << pair.first
+             << " count " << setw(10) << stats.count
+             << " total Rs " << setw(16) << formatPaise(stats.total)
+             << " avg Rs " << setw(14) << formatPaise(stats.total / static_cast<long long>(stats.count))
+             << " min Rs " << setw(14) << formatPaise(stats.min_balance)
+             << " max Rs " << formatPaise(stats.max_balance);
+    }
+
+    static const char *bucket_labels[BALANCE_BUCKETS] = {"< Rs 1K", "< Rs 10K", "< Rs 100K", "< Rs 1M", "< Rs 10M", ">= Rs 10M"};
+    setConsoleColor(14);
+    cout << "\n\n\tBalance Distribution";
+    setConsoleColor(7);
+    for (int b = 0; b < BALANCE_BUCKETS; b++)
+    {
+        size_t bar = report.accounts == 0 ? 0 : report.balance_histogram[b] * 40 / report.accounts;
+        cout << "\n\t" << left << setw(12) << bucket_labels[b] << setw(10) << report.balance_histogram[b] << string(bar, '#');
+    }
+
+    static const char *cohort_labels[AGE_COHORTS] = {"< 30 days", "< 6 months", "< 1 year", "< 3 years", ">= 3 years"};
+    setConsoleColor(14);
+    cout << "\n\n\tAccount Age Cohorts";
+    setConsoleColor(7);
+    for (int c = 0; c < AGE_COHORTS; c++)
+    {
+        cout << "\n\t" << left << setw(12) << cohort_labels[c] << report.age_cohorts[c];
+    }
+
+    setConsoleColor(14);
+    cout << "\n\n\tDaily Transaction Volume (last 7 active days, UTC)";
+    setConsoleColor(7);
+    if (report.daily_volume.empty())
+    {
+        cout << "\n\tNo ledger entries yet.";
+    }
+    int shown = 0;
+    for (auto it = report.daily_volume.rbegin(); it != report.daily_volume.rend() && shown < 7; ++it, ++shown)
+    {
+        time_t day_start = static_cast<time_t>(it->first * 86400);
+        char day_label[16];
+        strftime(day_label, sizeof(day_label), "%Y-%m-%d", gmtime(&day_start));
+        cout << "\n\t" << left << setw(12) << day_label << setw(10) << it->second.count << "Rs " << formatPaise(it->second.total);
+    }
+
+    cout << "\n\n\t(Computed in " << elapsed_ms << " ms)";
+    cout << "\n\n\tPress C to run the snapshot consistency check, F to benchmark the account filter,"
+         << "\n\tB to benchmark balance reads, L to benchmark batched lookups, or any other key to return to menu...";
+    int key = readKey();
+    if (key == 'c' || key == 'C')
+    {
+        runSnapshotConsistencyCheck();
+    }
+    else if (key == 'f' || key == 'F')
+    {
+        runAccountFilterBenchmark();
+    }
+    else if (key == 'b' || key == 'B')
+    {
+        runBalanceReadBenchmark();
+    }
+    else if (key == 'l' || key == 'L')
+    {
+        runBatchLookupBenchmark();
+    }
+    showEmployeeMenu();
+}
+
+
+// Self-check for snapshot reads, on a scratch book so no real data is touched: writer threads move
+// money between random accounts (serialized by one lock, as in server mode) while reader threads
+// repeatedly total every balance from a snapshot without taking that lock. Transfers conserve
+// money, so every snapshot total must equal the opening total.
+void Bank::runSnapshotConsistencyCheck()
+{
+    displayAppTitle();
+    cout << "\n\t\tSNAPSHOT CONSISTENCY CHECK\n";
+
+    const int ACCOUNTS = 100000, WRITERS = 2, READERS = 2;
+    const chrono::seconds DURATION(3);
+    Bank scratch(""); // No record file: starts empty and is never saved
+    vector<int> order(ACCOUNTS);
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), mt19937(42)); // Random insertion order keeps the tree shallow
+    for (int i : order)
+    {
+        char acc_no[16];
+        snprintf(acc_no, sizeof(acc_no), "%010d", 1000000 + i);
+        scratch.root = scratch.insert(scratch.root, {acc_no, "Check", "01/01/1990", "35", "Scratch", "0000000000",
+                                                     "1000.00", i % 2 ? "Saving" : "Current", "", ""});
+    }
+    const size_t opened = scratch.accountDirectory.size();
+    const long long expected_total = static_cast<long long>(opened) * 100000;
+
+    mutex write_lock;
+    atomic<bool> running{true};
+    atomic<size_t> transfers{0}, scans{0}, mismatches{0};
+    atomic<long long> scan_us{0};
+    vector<thread> threads;
+    for (int w = 0; w < WRITERS; w++)
+    {
+        threads.emplace_back([&, w]()
+        {
+            mt19937 rng(1234 + w);
+            uniform_int_distribution<size_t> pick(0, opened - 1);
+            uniform_int_distribution<long long> amount(1, 50000);
+            while (running)
+            {
+                lock_guard<mutex> lock(write_lock);
+                AccountNode *from = scratch.accountDirectory[pick(rng)];
+                AccountNode *to = scratch.accountDirectory[pick(rng)];
+                long long paise = amount(rng);
+                long long from_balance = parseAmountToPaise(from->balance);
+                if (from == to || paise > from_balance)
+                    continue;
+                from->balance = formatPaise(from_balance - paise);
+                to->balance = formatPaise(parseAmountToPaise(to->balance) + paise);
+                scratch.commitVersions({from, to});
+                transfers++;
+            }
+        });
+    }
+    for (int r = 0; r < READERS; r++)
+    {
+        threads.emplace_back([&]()
+        {
+            while (running)
+            {
+                auto started = chrono::steady_clock::now();
+                Snapshot snapshot(scratch.versionRegistry);
+                long long total = 0;
+                size_t count = scratch.accountDirectory.size();
+                for (size_t i = 0; i < count; i++)
+                {
+                    const BalanceVersion *version = snapshot.read(scratch.accountDirectory[i]);
+                    if (version != nullptr)
+                        total += version->balance;
+                }
+                if (total != expected_total)
+                    mismatches++;
+                scans++;
+                scan_us += chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - started).count();
+            }
+        });
+    }
+    this_thread::sleep_for(DURATION);
+    running = false;
+    for (thread &t : threads)
+        t.join();
+
+    cout << "\n\tAccounts: " << opened << ", opening total Rs " << formatPaise(expected_total);
+    cout << "\n\tTransfers committed: " << transfers << " (" << transfers / DURATION.count() << "/s)";
+    cout << "\n\tSnapshot scans: " << scans << " (avg " << (scans ? scan_us / static_cast<long long>(scans) : 0) << " us)";
+    setConsoleColor(mismatches == 0 ? 10 : 12);
+    cout << "\n\tInconsistent totals: " << mismatches;
+    setConsoleColor(7);
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+}
+
+
+// Account filter measurement on a scratch book: even account numbers are opened, odd ones are
+// probed as misses (typos one digit away from real accounts). Reports the false-positive rate
+// and the cost of a miss with and without the filter, plus the live book's filter footprint.
+void Bank::runAccountFilterBenchmark()
+{
+    displayAppTitle();
+    cout << "\n\t\tACCOUNT FILTER BENCHMARK\n";
+
+    const int ACCOUNTS = 200000, PROBES = 1000000;
+    Bank scratch(""); // No record file: starts empty and is never saved
+    vector<int> order(ACCOUNTS);
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), mt19937(42)); // Random insertion order keeps the tree shallow
+    char acc_no[16];
+    for (int i : order)
+    {
+        snprintf(acc_no, sizeof(acc_no), "%010d", 1000000 + 2 * i);
+        scratch.root = scratch.insert(scratch.root, {acc_no, "Check", "01/01/1990", "35", "Scratch", "0000000000",
+                                                     "1000.00", "Saving", "", ""});
+    }
+
+    mt19937 rng(7);
+    uniform_int_distribution<int> pick(0, ACCOUNTS - 1);
+    vector<string> misses(PROBES), hits(PROBES);
+    for (int i = 0; i < PROBES; i++)
+    {
+        int n = pick(rng);
+        snprintf(acc_no, sizeof(acc_no), "%010d", 1000000 + 2 * n + 1);
+        misses[i] = acc_no;
+        snprintf(acc_no, sizeof(acc_no), "%010d", 1000000 + 2 * n);
+        hits[i] = acc_no;
+    }
+
+    size_t false_positives = 0, found = 0;
+    auto timeNs = [&](auto &&lookup, const vector<string> &keys)
+    {
+        auto started = chrono::steady_clock::now();
+        for (const string &key : keys)
+            found += lookup(key) != nullptr;
+        return chrono::duration<double, nano>(chrono::steady_clock::now() - started).count() / keys.size();
+    };
+    for (const string &key : misses)
+        false_positives += scratch.accountFilter.mayContain(key);
+    double miss_tree = timeNs([&](const string &key) { return scratch.search(scratch.root, key); }, misses);
+    double miss_filtered = timeNs([&](const string &key) { return scratch.findAccount(key); }, misses);
+    double hit_tree = timeNs([&](const string &key) { return scratch.search(scratch.root, key); }, hits);
+    double hit_filtered = timeNs([&](const string &key) { return scratch.findAccount(key); }, hits);
+
+    cout << fixed << setprecision(1);
+    cout << "\n\tScratch book: " << ACCOUNTS << " accounts, filter " << scratch.accountFilter.memoryBytes() / 1024 << " KB";
+    cout << "\n\tFalse positives: " << false_positives << " of " << PROBES << " misses ("
+         << 100.0 * false_positives / PROBES << "%)";
+    cout << "\n\tMiss lookup:  " << miss_tree << " ns tree only, " << miss_filtered << " ns with filter";
+    cout << "\n\tHit lookup:   " << hit_tree << " ns tree only, " << hit_filtered << " ns with filter";
+    cout << "\n\tLive book: " << accountFilter.size() << " accounts, filter " << accountFilter.memoryBytes() / 1024 << " KB";
+    cout << defaultfloat << setprecision(6);
+    if (found != 2 * static_cast<size_t>(PROBES))
+    {
+        setConsoleColor(12);
+        cout << "\n\tError: filtered lookups disagreed with the tree.";
+        setConsoleColor(7);
+    }
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+}
+
+
+// Batched lookups against looped single lookups on a scratch book of 1M accounts (a few hundred MB
+// of nodes, far more than the caches hold), for random existing numbers with 10% unknown ones mixed
+// in. Both ways must resolve every number to the same account.
+void Bank::runBatchLookupBenchmark()
+{
+    displayAppTitle();
+    cout << "\n\t\tBATCHED LOOKUP BENCHMARK\n";
+    cout << "\n\tBuilding the scratch book...";
+    cout.flush();
+
+    const int ACCOUNTS = 1000000, LOOKUPS = 2000000;
+    Bank scratch(""); // No record file: starts empty and is never saved
+    vector<int> order(ACCOUNTS);
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), mt19937(42)); // Random insertion order keeps the tree shallow
+    char acc_no[16];
+    for (int i : order)
+    {
+        snprintf(acc_no, sizeof(acc_no), "%010d", 1000000 + 2 * i);
+        scratch.root = scratch.insert(scratch.root, {acc_no, "Check", "01/01/1990", "35", "Scratch", "0000000000",
+                                                     "1000.00", "Saving", "", ""});
+    }
+
+    mt19937 rng(7);
+    uniform_int_distribution<int> pick(0, ACCOUNTS - 1);
+    vector<string> keys(LOOKUPS);
+    for (string &key : keys)
+    {
+        int n = pick(rng);
+        snprintf(acc_no, sizeof(acc_no), "%010d", 1000000 + 2 * n + (rng() % 10 == 0)); // Odd numbers don't exist
+        key = acc_no;
+    }
+
+    vector<AccountNode *> single(LOOKUPS), batched(LOOKUPS);
+    auto started = chrono::steady_clock::now();
+    for (int i = 0; i < LOOKUPS; i++)
+        single[i] = scratch.findAccount(keys[i]);
+    double single_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - started).count() / LOOKUPS;
+    started = chrono::steady_clock::now();
+    scratch.findAccounts(keys.data(), keys.size(), batched.data());
+    double batched_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - started).count() / LOOKUPS;
+
+    size_t found = LOOKUPS - static_cast<size_t>(count(single.begin(), single.end(), nullptr));
+    cout << fixed << setprecision(1);
+    cout << "\n\tScratch book: " << ACCOUNTS << " accounts (~" << ACCOUNTS * sizeof(AccountNode) / (1024 * 1024)
+         << " MB of nodes), " << LOOKUPS << " lookups, " << found << " found";
+    cout << "\n\tLooped single lookups: " << single_ns << " ns each (" << static_cast<long long>(1e9 / single_ns) << "/s)";
+    cout << "\n\tBatched lookups:       " << batched_ns << " ns each (" << static_cast<long long>(1e9 / batched_ns)
+         << "/s, " << LOOKUP_LANES << " in flight)";
+    cout << "\n\tSpeedup: " << setprecision(2) << single_ns / batched_ns << "x";
+    cout << defaultfloat << setprecision(6);
+    if (single != batched)
+    {
+        setConsoleColor(12);
+        cout << "\n\tError: batched lookups disagreed with single lookups.";
+        setConsoleColor(7);
+    }
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+}
+
+
+// Balance read scaling on a scratch book while a writer thread keeps transferring. Each round runs
+// N reader threads for a fixed time, first reading under the book lock (as the server did before
+// balance cells) and then from the balance cells with no lock. The writer stamps every account's
+// activity text with its balance, so a reader that sees a mismatched pair has caught a torn read.
+void Bank::runBalanceReadBenchmark()
+{
+    displayAppTitle();
+    cout << "\n\t\tBALANCE READ BENCHMARK\n";
+
+    const int ACCOUNTS = 100000;
+    const chrono::milliseconds ROUND(1000);
+    Bank scratch(""); // No record file: starts empty and is never saved
+    vector<int> order(ACCOUNTS);
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), mt19937(42)); // Random insertion order keeps the tree shallow
+    char text[32];
+    for (int i : order)
+    {
+        snprintf(text, sizeof(text), "%010d", 1000000 + i);
+        string acc_no = text;
+        snprintf(text, sizeof(text), "%024lld", 100000LL);
+        scratch.root = scratch.insert(scratch.root, {acc_no, "Check", "01/01/1990", "35", "Scratch", "0000000000",
+                                                     "1000.00", "Saving", "", text});
+    }
+    const size_t opened = scratch.accountDirectory.size();
+    vector<string> numbers(opened);
+    vector<const BalanceCell *> cells(opened);
+    for (size_t i = 0; i < opened; i++)
+    {
+        numbers[i] = scratch.accountDirectory[i]->account_number;
+        cells[i] = scratch.balanceCell(numbers[i]);
+    }
+
+    mutex book_lock;
+    atomic<bool> writing{true};
+    atomic<size_t> transfers{0}, torn{0};
+    thread writer([&]()
+    {
+        mt19937 rng(99);
+        uniform_int_distribution<size_t> pick(0, opened - 1);
+        uniform_int_distribution<long long> amount(1, 50000);
+        char stamp[32];
+        while (writing)
+        {
+            lock_guard<mutex> lock(book_lock);
+            AccountNode *from = scratch.accountDirectory[pick(rng)];
+            AccountNode *to = scratch.accountDirectory[pick(rng)];
+            long long paise = amount(rng);
+            long long from_balance = parseAmountToPaise(from->balance);
+            if (from == to || paise > from_balance)
+                continue;
+            from->balance = formatPaise(from_balance - paise);
+            snprintf(stamp, sizeof(stamp), "%024lld", from_balance - paise);
+            from->last_transaction = stamp;
+            long long to_balance = parseAmountToPaise(to->balance) + paise;
+            to->balance = formatPaise(to_balance);
+            snprintf(stamp, sizeof(stamp), "%024lld", to_balance);
+            to->last_transaction = stamp;
+            scratch.commitVersions({from, to});
+            transfers++;
+        }
+    });
+
+    // Reads per second with the given number of readers; read(i) looks up account i
+    auto measure = [&](unsigned readers, auto &&read)
+    {
+        atomic<bool> running{true};
+        atomic<size_t> reads{0};
+        vector<thread> threads;
+        for (unsigned r = 0; r < readers; r++)
+        {
+            threads.emplace_back([&, r]()
+            {
+                mt19937 rng(500 + r);
+                uniform_int_distribution<size_t> pick(0, opened - 1);
+                size_t done = 0;
+                while (running)
+                {
+                    for (int batch = 0; batch < 256; batch++)
+                        read(pick(rng));
+                    done += 256;
+                }
+                reads += done;
+            });
+        }
+        this_thread::sleep_for(ROUND);
+        running = false;
+        for (thread &t : threads)
+            t.join();
+        return reads * 1000.0 / ROUND.count();
+    };
+    auto locked = [&](size_t i)
+    {
+        lock_guard<mutex> lock(book_lock);
+        AccountNode *account = scratch.findAccount(numbers[i]);
+        long long paise = parseAmountToPaise(account->balance);
+        if (paise != atoll(account->last_transaction.c_str()))
+            torn++;
+    };
+    auto lock_free = [&](size_t i)
+    {
+        long long paise;
+        string last_activity;
+        cells[i]->read(paise, last_activity);
+        if (paise != atoll(last_activity.c_str()))
+            torn++;
+    };
+
+    unsigned max_readers = max(2u, thread::hardware_concurrency());
+    cout << "\n\tAccounts: " << opened << ", one writer transferring throughout";
+    cout << "\n\n\t" << left << setw(10) << "Readers" << setw(20) << "Locked reads/s" << "Lock-free reads/s";
+    cout << fixed << setprecision(0);
+    for (unsigned readers = 1; readers <= max_readers; readers *= 2)
+    {
+        double with_lock = measure(readers, locked);
+        double without_lock = measure(readers, lock_free);
+        cout << "\n\t" << setw(10) << readers << setw(20) << with_lock << without_lock;
+    }
+    cout << defaultfloat << setprecision(6) << right;
+    writing = false;
+    writer.join();
+
+    cout << "\n\n\tTransfers committed meanwhile: " << transfers;
+    cout << "\n\tCores: " << thread::hardware_concurrency();
+    setConsoleColor(torn == 0 ? 10 : 12);
+    cout << "\n\tTorn reads: " << torn;
+    setConsoleColor(7);
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+}
+
+
+// Statements in one pass over the ledger. Every entry is split into per-account legs (a transfer
+// debits one account and credits another) and the legs are bucketed by account with a counting
+// sort, which keeps each account's legs in ledger order. Balances are rebuilt backwards from the
+// current balance, so no per-account query is needed. Workers then format contiguous runs of
+// accounts into large buffers and write one part file each.
+size_t Bank::generateStatements(const vector<LedgerEntry> &ledger, long long from_day, long long to_day,
+                                const string &prefix, size_t &files_written)
+{
+    struct Leg
+    {
+        size_t entry;    // Index into ledger
+        long long delta; // Signed change to this account's balance
+    };
+
+    vector<AccountNode *> accounts;
+    collectAllAccounts(accounts);
+    unordered_map<string, size_t> index_of(accounts.size());
+    for (size_t i = 0; i < accounts.size(); i++)
+        index_of.emplace(accounts[i]->account_number, i);
+
+    // Pass 1: legs per account; pass 2: scatter them into account-grouped order
+    auto forEachLeg = [&](auto &&visit)
+    {
+        for (size_t e = 0; e < ledger.size(); e++)
+        {
+            const LedgerEntry &entry = ledger[e];
+            bool debit = entry.kind == "Withdrawal" || entry.kind == "Transfer";
+            auto found = index_of.find(entry.account);
+            if (found != index_of.end())
+                visit(found->second, Leg{e, debit ? -entry.amount : entry.amount});
+            if (entry.kind == "Transfer" && (found = index_of.find(entry.counterparty)) != index_of.end())
+                visit(found->second, Leg{e, entry.amount});
+        }
+    };
+    vector<size_t> first_leg(accounts.size() + 1, 0);
+    forEachLeg([&](size_t account, const Leg &) { first_leg[account + 1]++; });
+    for (size_t i = 0; i < accounts.size(); i++)
+        first_leg[i + 1] += first_leg[i];
+    vector<Leg> legs(first_leg.back());
+    vector<size_t> fill(first_leg.begin(), first_leg.end() - 1);
+    forEachLeg([&](size_t account, const Leg &leg) { legs[fill[account]++] = leg; });
+
+    char from_label[16], to_label[16];
+    auto dayLabel = [](long long day, char *label)
+    {
+        time_t start = static_cast<time_t>(day * 86400);
+        tm parts;
+#ifdef _WIN32
+        gmtime_s(&parts, &start);
+#else
+        gmtime_r(&start, &parts);
+#endif
+        strftime(label, 16, "%Y-%m-%d", &parts);
+    };
+    dayLabel(from_day, from_label);
+    dayLabel(to_day, to_label);
+
+    size_t workers = parallelWorkerCount(accounts.size());
+    vector<char> file_ok(workers, 0);
+    runParallelChunks(accounts.size(), workers, [&](size_t begin, size_t end, size_t chunk)
+    {
+        FILE *file = fopen((prefix + "_part" + to_string(chunk + 1) + ".txt").c_str(), "wb");
+        if (file == nullptr)
+            return;
+        string buffer;
+        buffer.reserve(EXPORT_FLUSH_BYTES * 2);
+        char line[160];
+        for (size_t a = begin; a < end; a++)
+        {
+            const AccountNode *account = accounts[a];
+            // Work back from the current balance: legs after the range give the closing balance,
+            // legs inside it the opening balance
+            long long closing = parseAmountToPaise(account->balance), in_range_total = 0;
+            bool any_in_range = false;
+            for (size_t l = first_leg[a]; l < first_leg[a + 1]; l++)
+            {
+                long long day = ledger[legs[l].entry].timestamp / 86400;
+                if (day > to_day)
+                    closing -= legs[l].delta;
+                else if (day >= from_day)
+                {
+                    in_range_total += legs[l].delta;
+                    any_in_range = true;
+                }
+            }
+            long long opening = closing - in_range_total;
+
+            buffer.append(90, '=');
+            buffer.append("\nACCOUNT STATEMENT  ").append(from_label).append(" to ").append(to_label).append(" (UTC)\n");
+            buffer.append("Account No.: ").append(account->account_number).append("   Name: ").append(account->name);
+            buffer.append("   Type: ").append(account->acc_type).append("\n");
+            buffer.append("Opening Balance: Rs ").append(formatPaise(opening)).append("\n\n");
+            snprintf(line, sizeof(line), "%-20s %-30s %12s %12s %14s\n", "Date", "Description", "Debit", "Credit", "Balance");
+            buffer.append(line);
+
+            long long running = opening;
+            for (size_t l = first_leg[a]; any_in_range && l < first_leg[a + 1]; l++)
+            {
+                const LedgerEntry &entry = ledger[legs[l].entry];
+                if (entry.timestamp / 86400 < from_day || entry.timestamp / 86400 > to_day)
+                    continue;
+                running += legs[l].delta;
+                time_t when = entry.timestamp;
+                tm parts;
+#ifdef _WIN32
+                gmtime_s(&parts, &when);
+#else
+                gmtime_r(&when, &parts);
+#endif
+                char stamp[24];
+                strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &parts);
+                string description = entry.kind;
+                if (entry.kind == "Transfer")
+                    description = legs[l].delta < 0 ? "Transfer to " + entry.counterparty : "Transfer from " + entry.account;
+                string amount = formatPaise(legs[l].delta < 0 ? -legs[l].delta : legs[l].delta);
+                snprintf(line, sizeof(line), "%-20s %-30.30s %12s %12s %14s\n", stamp, description.c_str(),
+                         legs[l].delta < 0 ? amount.c_str() : "", legs[l].delta < 0 ? "" : amount.c_str(), formatPaise(running).c_str());
+                buffer.append(line);
+            }
+            if (!any_in_range)
+                buffer.append("No transactions in this period.\n");
+            buffer.append("\nClosing Balance: Rs ").append(formatPaise(closing)).append("\n\n");
+
+            if (buffer.size() >= EXPORT_FLUSH_BYTES)
+            {
+                fwrite(buffer.data(), 1, buffer.size(), file);
+                buffer.clear();
+            }
+        }
+        fwrite(buffer.data(), 1, buffer.size(), file);
+        file_ok[chunk] = fclose(file) == 0;
+    });
+
+    files_written = static_cast<size_t>(count(file_ok.begin(), file_ok.end(), 1));
+    return files_written == workers ? accounts.size() : 0;
+}
+
+
+void Bank::manageStatements()
+{
+    displayAppTitle();
+    cout << "\n\t\tSTATEMENTS AND ARCHIVE\n";
+    const string archive_path = "Transaction_archive.bin";
+    time_t covered = TransactionArchive::coveredUntil(archive_path);
+    cout << "\n\tLedger entries in Transaction_log.csv: " << transactionLedger.size();
+    if (covered != 0)
+        cout << "\n\tArchived: everything before " << formatDateTime(covered);
+
+    int choice;
+    cout << "\n\n\t1. Generate Account Statements\n\t2. Archive Old Ledger Entries\n\t3. Search the Archive\n\t4. Return to Employee Menu\n\tChoice: ";
+    while (!(cin >> choice) || choice < 1 || choice > 4) {
+        setConsoleColor(12);
+        cout << "\n\tInvalid choice. Please enter a number between 1 and 4: ";
+        setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    auto readDay = [](const string &prompt) -> long long
+    {
+        string text;
+        int year, month, day;
+        cout << "\n\t" << prompt << " (YYYY-MM-DD): ";
+        while (!(cin >> text) || sscanf(text.c_str(), "%d-%d-%d", &year, &month, &day) != 3 ||
+               month < 1 || month > 12 || day < 1 || day > 31 || year < 1970) {
+            setConsoleColor(12);
+            cout << "\n\tInvalid date. Please use YYYY-MM-DD: ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        return daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    };
+
+    if (choice == 1)
+    {
+        long long from_day = readDay("From Date");
+        long long to_day = readDay("To Date");
+        if (to_day < from_day)
+            swap(from_day, to_day);
+
+        auto started = chrono::steady_clock::now();
+        size_t files = 0, statements;
+        time_t range_start = static_cast<time_t>(from_day * 86400);
+        if (range_start < covered)
+        {
+            // Part of the range is archived: statements need those entries in front of the live ledger
+            vector<LedgerEntry> history;
+            TransactionArchive::scan(archive_path, range_start, covered - 1, "", history);
+            // Live entries before 'covered' are already in the archive (a run that crashed before trimming)
+            copy_if(transactionLedger.begin(), transactionLedger.end(), back_inserter(history),
+                    [covered](const LedgerEntry &entry) { return entry.timestamp >= covered; });
+            statements = generateStatements(history, from_day, to_day, "Statements", files);
+        }
+        else
+        {
+            statements = generateStatements(transactionLedger, from_day, to_day, "Statements", files);
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+        if (statements == 0 && root != nullptr)
+        {
+            setConsoleColor(12);
+            cout << "\n\tError: Could not write the statement files.";
+        }
+        else
+        {
+            setConsoleColor(10);
+            cout << "\n\t" << statements << " statement(s) written to " << files << " file(s) (Statements_part1.txt ...) in "
+                 << fixed << setprecision(3) << seconds << " s.";
+            cout.unsetf(ios::floatfield);
+            cout << setprecision(6);
+        }
+        setConsoleColor(7);
+    }
+    else if (choice == 2)
+    {
+        int days;
+        cout << "\n\tArchive entries older than how many days (30-3650): ";
+        while (!(cin >> days) || days < 30 || days > 3650) {
+            setConsoleColor(12);
+            cout << "\n\tInvalid value. Please enter a number between 30 and 3650: ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        time_t cutoff = (time(0) / 86400 - days) * 86400; // Start of a UTC day
+        size_t archived = 0, archive_bytes = 0, text_bytes = 0;
+        if (archiveLedgerBefore(cutoff, archived, archive_bytes, text_bytes))
+        {
+            setConsoleColor(10);
+            cout << "\n\t" << archived << " entries archived: " << archive_bytes << " bytes (" << text_bytes << " bytes as CSV text).";
+        }
+        else
+        {
+            setConsoleColor(12);
+            cout << "\n\tError: Could not write the archive, the ledger was left unchanged.";
+        }
+        setConsoleColor(7);
+    }
+    else if (choice == 3)
+    {
+        string acc_no;
+        cout << "\n\tAccount Number (* for all): ";
+        cin >> acc_no;
+        long long from_day = readDay("From Date");
+        long long to_day = readDay("To Date");
+        vector<LedgerEntry> found;
+        size_t blocks_read = 0, blocks_skipped = 0;
+        auto started = chrono::steady_clock::now();
+        bool ok = TransactionArchive::scan(archive_path, static_cast<time_t>(from_day * 86400), static_cast<time_t>(to_day * 86400 + 86399),
+                                           acc_no == "*" ? "" : acc_no, found, &blocks_read, &blocks_skipped);
+        auto elapsed_ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started).count();
+        if (!ok)
+        {
+            setConsoleColor(12);
+            cout << "\n\tError: The archive is damaged; showing the entries read before the damage.";
+            setConsoleColor(7);
+        }
+        const size_t SHOWN = 50;
+        for (size_t i = 0; i < found.size() && i < SHOWN; i++)
+        {
+            cout << "\n\t" << formatDateTime(found[i].timestamp) << "  " << left << setw(11) << found[i].kind << setw(12)
+                 << found[i].account << setw(12) << found[i].counterparty << "Rs " << formatPaise(found[i].amount);
+        }
+        cout << "\n\n\t" << found.size() << " entries (" << min(found.size(), SHOWN) << " shown), " << blocks_read
+             << " block(s) read, " << blocks_skipped << " skipped, " << elapsed_ms << " ms.";
+    }
+    else
+    {
+        showEmployeeMenu();
+        return;
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    manageStatements();
+}
+
+
+// Startup load. The record file is memory-mapped on Linux (read whole elsewhere) and split into
+// one chunk per worker at line boundaries; workers build their accounts straight from the mapped
+// bytes. Bank_Record.csv is written in account-number order, so the tree is linked balanced in
+// one linear pass instead of inserting line by line (which degenerates into a list on sorted
+// input); an out-of-order file is sorted first. Duplicate numbers keep the first line, as before.
+void Bank::loadAccountsFromFile()
+{
+    const char *data = nullptr;
+    size_t size = 0;
+#ifdef __linux__
+    int fd = open(recordFile.c_str(), O_RDONLY);
+    if (fd < 0)
+        return; // If file doesn't exist, it's fine for first run
+    struct stat info;
+    void *mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        size = static_cast<size_t>(info.st_size);
+        mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapped == MAP_FAILED)
+        return;
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(mapped);
+#else
+    ifstream file(recordFile, ios::binary | ios::ate);
+    if (!file.is_open())
+        return; // If file doesn't exist, it's fine for first run
+    string buffer(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(&buffer[0], static_cast<streamsize>(buffer.size()));
+    file.close();
+    data = buffer.data();
+    size = buffer.size();
+#endif
+
+    unsigned long long stamp = versionRegistry.beginCommit();
+    size_t workers = parallelWorkerCount(size / 64); // Roughly 64+ bytes per record
+    vector<vector<AccountNode *>> chunk_accounts(workers);
+    runParallelChunks(size, workers, [&](size_t begin, size_t end, size_t chunk)
+    {
+        vector<AccountNode *> &out = chunk_accounts[chunk];
+        size_t pos = begin;
+        if (begin > 0) // Skip the line that started in the previous chunk
+        {
+            const char *newline = static_cast<const char *>(memchr(data + begin - 1, '\n', size - begin + 1));
+            pos = newline == nullptr ? size : static_cast<size_t>(newline - data) + 1;
+        }
+        while (pos < end)
+        {
+            const char *line = data + pos;
+            const char *line_end = static_cast<const char *>(memchr(line, '\n', size - pos));
+            if (line_end == nullptr)
+                line_end = data + size;
+            pos = static_cast<size_t>(line_end - data) + 1;
+
+            // Anything after the schema's fields is ignored, as before; short lines are skipped
+            AccountNode *account = new AccountNode();
+            if (decodeRecordCsv(line, line_end, *account) == nullptr)
+            {
+                delete account;
+                continue;
+            }
+            long long paise = parseAmountToPaise(account->balance);
+            account->created_stamp = stamp;
+            account->versions.store(new BalanceVersion(paise, account->last_transaction, stamp), memory_order_relaxed);
+            account->published.publish(paise, account->last_transaction);
+            out.push_back(account);
+        }
+    });
+#ifdef __linux__
+    munmap(mapped, size);
+#endif
+
+    vector<AccountNode *> accounts;
+    size_t total = 0;
+    for (const auto &chunk : chunk_accounts)
+        total += chunk.size();
+    accounts.reserve(total);
+    for (auto &chunk : chunk_accounts)
+    {
+        accounts.insert(accounts.end(), chunk.begin(), chunk.end());
+        vector<AccountNode *>().swap(chunk);
+    }
+
+    sortLoadedAccounts(accounts);
+    root = linkBalanced(accounts.data(), accounts.size());
+    registerLoadedAccounts(accounts);
+    versionRegistry.endCommit(stamp);
+}
+
+// Startup benchmark: writes a synthetic, sorted record file and times constructing a Bank from it
+void Bank::runStartupBenchmark()
+{
+    displayAppTitle();
+    cout << "\n\t\tSTARTUP LOAD BENCHMARK\n";
+
+    long long accounts;
+    cout << "\n\tNumber of accounts to load (100000 - 20000000): ";
+    while (!(cin >> accounts) || accounts < 100000 || accounts > 20000000) {
+        setConsoleColor(12);
+        cout << "\n\tInvalid number. Please enter a value between 100000 and 20000000: ";
+        setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    const string path = "Startup_benchmark.csv";
+    const string opened = getCurrentDateTime();
+    {
+        ofstream file(path, ios::binary | ios::trunc);
+        string buffer;
+        char line[256];
+        for (long long i = 0; i < accounts && file; i++)
+        {
+            int length = snprintf(line, sizeof(line), "%010lld,Customer %lld,01/01/1990,35,Address %lld,98%08lld,%lld.%02lld,%s,%s,%s\n",
+                                  1000000000LL + i, i, i, (i * 7919) % 10000000, i % 100000, i % 100,
+                                  i % 2 ? "Saving" : "Current", opened.c_str(), opened.c_str());
+            buffer.append(line, static_cast<size_t>(length));
+            if (buffer.size() >= EXPORT_FLUSH_BYTES)
+            {
+                file.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+                buffer.clear();
+            }
+        }
+        file.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+        if (!file)
+        {
+            setConsoleColor(12);
+            cout << "\n\tError: Could not write " << path << ".";
+            setConsoleColor(7);
+            remove(path.c_str());
+            cout << "\n\n\tPress any key to return to menu...";
+            readKey();
+            return;
+        }
+    }
+
+    cout << "\n\tLoading " << accounts << " accounts...";
+    auto started = chrono::steady_clock::now();
+    size_t loaded;
+    {
+        Bank book(path);
+        loaded = book.accountDirectory.size();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        setConsoleColor(10);
+        cout << "\n\tLoaded " << loaded << " accounts in " << fixed << setprecision(3) << seconds << " s ("
+             << setprecision(2) << loaded / seconds / 1e6 << " M accounts/s, " << parallelWorkerCount(loaded) << " worker(s))";
+        setConsoleColor(7);
+
+        // Record codec throughput on one thread: encode every account, then decode into a scratch node
+        auto timeNs = [loaded](auto &&pass)
+        {
+            auto pass_started = chrono::steady_clock::now();
+            pass();
+            return chrono::duration<double, nano>(chrono::steady_clock::now() - pass_started).count() / loaded;
+        };
+        string csv, binary;
+        AccountNode scratch;
+        size_t decoded = 0;
+        double csv_encode = timeNs([&]()
+        {
+            for (size_t i = 0; i < loaded; i++)
+            {
+                appendRecordCsv(csv, book.accountDirectory[i]);
+                csv.push_back('\n');
+            }
+        });
+        double binary_encode = timeNs([&]()
+        {
+            for (size_t i = 0; i < loaded; i++)
+                appendRecordBinary(binary, book.accountDirectory[i]);
+        });
+        double csv_decode = timeNs([&]()
+        {
+            for (const char *p = csv.data(), *end = p + csv.size(); p < end; decoded++)
+            {
+                const char *line_end = static_cast<const char *>(memchr(p, '\n', static_cast<size_t>(end - p)));
+                decodeRecordCsv(p, line_end, scratch);
+                p = line_end + 1;
+            }
+        });
+        double binary_decode = timeNs([&]()
+        {
+            for (const char *p = binary.data(), *end = p + binary.size(); p != nullptr && p < end; decoded++)
+                p = decodeRecordBinary(p, end, scratch);
+        });
+        cout << "\n\tRecord codecs: CSV " << setprecision(0) << csv_encode << " ns encode / " << csv_decode << " ns decode ("
+             << csv.size() / loaded << " B), binary " << binary_encode << " ns / " << binary_decode << " ns ("
+             << binary.size() / loaded << " B)";
+        cout.unsetf(ios::floatfield);
+        cout << setprecision(6);
+        if (decoded != 2 * loaded)
+        {
+            setConsoleColor(12);
+            cout << "\n\tError: decoded " << decoded << " records, expected " << 2 * loaded << ".";
+            setConsoleColor(7);
+        }
+    }
+    remove(path.c_str());
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+}
+
+const char *const Bank::BULK_HEADER =
+    "account_number,name,dob,age,address,phone,balance,acc_type,creation_date,last_transaction,password";
+
+// Bulk import: the file is read whole and split into one chunk per worker at line boundaries (a
+// line belongs to the chunk it starts in). Workers validate their lines and drop numbers already
+// in the book; the rows are then sorted (a no-op check for sorted input), deduplicated, and
+// merged with the existing accounts into a freshly balanced tree in one linear pass. Both files
+// are written once at the end.
+Bank::BulkImportResult Bank::bulkImport(const string &path)
+{
+    BulkImportResult result;
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file.is_open())
+        return result;
+    string data(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(&data[0], static_cast<streamsize>(data.size()));
+    file.close();
+
+    struct Row
+    {
+        AccountNode *account; // Decoded record, not yet in the book
+        string password;
+        size_t line; // Input order, keeps the first of several rows with the same number
+    };
+    size_t workers = parallelWorkerCount(data.size() / 64); // Roughly 64+ bytes per record
+    vector<vector<Row>> chunk_rows(workers);
+    vector<size_t> chunk_invalid(workers, 0), chunk_duplicates(workers, 0);
+    const string now = getCurrentDateTime();
+    runParallelChunks(data.size(), workers, [&](size_t begin, size_t end, size_t chunk)
+    {
+        size_t pos = begin;
+        if (begin > 0) // Skip the line that started in the previous chunk
+        {
+            size_t newline = data.find('\n', begin - 1);
+            pos = newline == string::npos ? data.size() : newline + 1;
+        }
+        while (pos < end && pos < data.size())
+        {
+            size_t line_end = data.find('\n', pos);
+            if (line_end == string::npos)
+                line_end = data.size();
+            size_t text_end = line_end > pos && data[line_end - 1] == '\r' ? line_end - 1 : line_end;
+            size_t line_start = pos;
+            pos = line_end + 1;
+            if (text_end == line_start || data.compare(line_start, text_end - line_start, BULK_HEADER) == 0)
+                continue;
+
+            // The record fields, then exactly one more: the password
+            const char *text = data.data() + line_start, *text_stop = data.data() + text_end;
+            unique_ptr<AccountNode> account(new AccountNode());
+            const char *rest = decodeRecordCsv(text, text_stop, *account);
+            const string &acc_no = account->account_number;
+            bool valid = rest != nullptr && rest != text_stop && rest + 1 != text_stop &&
+                         memchr(rest + 1, ',', static_cast<size_t>(text_stop - rest - 1)) == nullptr &&
+                         !acc_no.empty() && !account->name.empty() &&
+                         all_of(acc_no.begin(), acc_no.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)); }) &&
+                         (account->acc_type == "Saving" || account->acc_type == "Current");
+            char *amount_end = nullptr;
+            double amount = valid ? strtod(account->balance.c_str(), &amount_end) : 0;
+            if (!valid || amount_end == account->balance.c_str() || *amount_end != '\0' || amount < 0)
+            {
+                chunk_invalid[chunk]++;
+                continue;
+            }
+            if (findAccount(acc_no) != nullptr || accountCredentials.count(acc_no)) // Read-only here
+            {
+                chunk_duplicates[chunk]++;
+                continue;
+            }
+            account->balance = formatPaise(parseAmountToPaise(account->balance));
+            if (account->creation_date.empty())
+                account->creation_date = now;
+            if (account->last_transaction.empty())
+                account->last_transaction = account->creation_date;
+            chunk_rows[chunk].push_back(Row{account.release(), string(rest + 1, text_stop), line_start});
+        }
+    });
+
+    vector<Row> rows;
+    for (size_t w = 0; w < workers; w++)
+    {
+        result.invalid += chunk_invalid[w];
+        result.duplicates += chunk_duplicates[w];
+        move(chunk_rows[w].begin(), chunk_rows[w].end(), back_inserter(rows));
+    }
+    auto byNumber = [](const Row &a, const Row &b)
+    {
+        const string &x = a.account->account_number, &y = b.account->account_number;
+        return x < y || (x == y && a.line < b.line);
+    };
+    if (!is_sorted(rows.begin(), rows.end(), byNumber))
+        sort(rows.begin(), rows.end(), byNumber);
+
+    // Plaintext passwords are hashed before they are stored (exported files already carry hashes).
+    // Each hash is deliberately slow, so they are spread over every core.
+    vector<string *> plaintext;
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        bool repeat = i > 0 && rows[i].account->account_number == rows[i - 1].account->account_number;
+        if (!repeat && rows[i].password.compare(0, PASSWORD_HASH_PREFIX.size(), PASSWORD_HASH_PREFIX) != 0)
+            plaintext.push_back(&rows[i].password);
+    }
+    if (!plaintext.empty())
+    {
+        size_t hardware = max(1u, thread::hardware_concurrency());
+        runParallelChunks(plaintext.size(), min(hardware, plaintext.size()), [&](size_t begin, size_t end, size_t)
+        {
+            for (size_t i = begin; i < end; i++)
+                *plaintext[i] = hashPassword(*plaintext[i]);
+        });
+    }
+
+    // Create the new accounts as one commit, skipping repeats of a number within the file
+    vector<AccountNode *> added;
+    added.reserve(rows.size());
+    unsigned long long stamp = versionRegistry.beginCommit();
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        AccountNode *account = rows[i].account;
+        if (i > 0 && account->account_number == added.back()->account_number)
+        {
+            delete account;
+            result.duplicates++;
+            continue;
+        }
+        added.push_back(registerAccount(stamp, account));
+        if (replicationLog != nullptr)
+            replicationLog->publish("O," + accountRecordLine(account) + "," + rows[i].password);
+        accountCredentials[account->account_number] = move(rows[i].password);
+    }
+    versionRegistry.endCommit(stamp);
+    result.imported = added.size();
+    if (added.empty())
+        return result;
+
+    // Merge with the existing accounts (both in order) and relink the whole tree balanced
+    vector<AccountNode *> existing, merged;
+    collectAllAccounts(existing);
+    merged.resize(existing.size() + added.size());
+    merge(existing.begin(), existing.end(), added.begin(), added.end(), merged.begin(),
+          [](const AccountNode *a, const AccountNode *b) { return a->account_number < b->account_number; });
+    root = linkBalanced(merged.data(), merged.size());
+
+    result.saved = writeAccountsFile(recordFile + ".tmp") && replaceFile(recordFile + ".tmp", recordFile);
+    saveAllCredentials();
+    return result;
+}
+
+// Bulk export: workers format contiguous runs of accounts (in account-number order) into their
+// own buffers, which are then written out in order as one file
+bool Bank::bulkExport(const string &path, size_t &exported)
+{
+    vector<AccountNode *> accounts;
+    collectAllAccounts(accounts);
+    size_t workers = parallelWorkerCount(accounts.size());
+    vector<string> buffers(workers);
+    runParallelChunks(accounts.size(), workers, [&](size_t begin, size_t end, size_t chunk)
+    {
+        string &out = buffers[chunk];
+        out.reserve((end - begin) * 128);
+        for (size_t i = begin; i < end; i++)
+        {
+            auto credentials = accountCredentials.find(accounts[i]->account_number); // Read-only here
+            appendRecordCsv(out, accounts[i]);
+            out += ',';
+            if (credentials != accountCredentials.end())
+                out += credentials->second;
+            out += '\n';
+        }
+    });
+
+    ofstream file(path + ".tmp", ios::binary | ios::trunc);
+    if (!file.is_open())
+        return false;
+    file << BULK_HEADER << '\n';
+    for (const string &buffer : buffers)
+        file.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+    file.close();
+    if (file.fail() || !replaceFile(path + ".tmp", path))
+        return false;
+    exported = accounts.size();
+    return true;
+}
+
+void Bank::manageBulkTransfer()
+{
+    displayAppTitle();
+    cout << "\n\t\tBULK IMPORT AND EXPORT\n";
+    cout << "\n\tFile layout (one account per line):\n\t" << BULK_HEADER;
+
+    int choice;
+    cout << "\n\n\t1. Import Accounts from CSV\n\t2. Export All Accounts to CSV\n\t3. Startup Load Benchmark"
+         << "\n\t4. Return to Employee Menu\n\tChoice: ";
+    while (!(cin >> choice) || choice < 1 || choice > 4) {
+        setConsoleColor(12);
+        cout << "\n\tInvalid choice. Please enter a number between 1 and 4: ";
+        setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    if (choice == 3)
+    {
+        runStartupBenchmark();
+        manageBulkTransfer();
+        return;
+    }
+    if (choice != 4)
+    {
+        string path;
+        cout << "\n\tEnter the file name: ";
+        cin >> path;
+        auto started = chrono::steady_clock::now();
+        if (choice == 1)
+        {
+            BulkImportResult result = bulkImport(path);
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+            if (result.imported == 0 && result.invalid == 0 && result.duplicates == 0)
+            {
+                setConsoleColor(12);
+                cout << "\n\tError: Nothing to import from " << path << ".";
+            }
+            else if (result.imported > 0 && !result.saved)
+            {
+                setConsoleColor(12);
+                cout << "\n\tError: Imported " << result.imported << " account(s) but could not save " << recordFile << ".";
+            }
+            else
+            {
+                setConsoleColor(10);
+                cout << "\n\tImported " << result.imported << " account(s) in " << fixed << setprecision(3) << seconds << " s.";
+                cout.unsetf(ios::floatfield);
+                cout << setprecision(6);
+            }
+            setConsoleColor(7);
+            cout << "\n\tSkipped: " << result.duplicates << " existing or repeated, " << result.invalid << " invalid.";
+        }
+        else
+        {
+            size_t exported = 0;
+            bool ok = bulkExport(path, exported);
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+            if (!ok)
+            {
+                setConsoleColor(12);
+                cout << "\n\tError: Could not write " << path << ".";
+            }
+            else
+            {
+                setConsoleColor(10);
+                cout << "\n\tExported " << exported << " account(s) to " << path << " in " << fixed << setprecision(3) << seconds << " s.";
+                cout.unsetf(ios::floatfield);
+                cout << setprecision(6);
+            }
+            setConsoleColor(7);
+        }
+    }
+    else
+    {
+        showEmployeeMenu();
+        return;
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    manageBulkTransfer();
+}
+
+
+// Credits one period of interest to every Saving account.
+// Balances are copied into a contiguous paise column and the interest column is computed in one
+// branch-free integer pass (round half up), so the loop vectorizes and no float rounding creeps in.
+// Nothing is visible until Bank_Record.csv is swapped in; see recoverInterestRun for the crash path.
+size_t Bank::postInterest(const InterestConfig &config, time_t run_id)
+{
+    vector<AccountNode *> all_accounts, savings;
+    collectAllAccounts(all_accounts);
+    for (AccountNode *node : all_accounts)
+    {
+        if (node->acc_type == "Saving")
+            savings.push_back(node);
+    }
+
+    const size_t n = savings.size();
+    vector<long long> balances(n), interest(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        balances[i] = parseAmountToPaise(savings[i]->balance);
+    }
+
+    const long long rate = config.annual_rate_bp;
+    const long long divisor = 10000LL * config.postings_per_year;
+    const long long half = divisor / 2;
+    const long long *in = balances.data();
+    long long *out = interest.data();
+    for (size_t i = 0; i < n; i++)
+    {
+        long long positive = in[i] > 0 ? in[i] : 0; // Overdrawn balances earn nothing
+        out[i] = (positive * rate + half) / divisor;
+    }
+
+    // Stage the new balances and the ledger batch
+    string run_tag = "INTEREST-RUN-" + to_string(static_cast<long long>(run_id));
+    string posting_time = getCurrentDateTime();
+    vector<string> old_balances(n), old_last_transaction(n);
+    vector<LedgerEntry> entries;
+    vector<AccountNode *> credited;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (out[i] == 0)
+            continue;
+        credited.push_back(savings[i]);
+        old_balances[i] = savings[i]->balance;
+        old_last_transaction[i] = savings[i]->last_transaction;
+        savings[i]->balance = formatPaise(balances[i] + out[i]);
+        savings[i]->last_transaction = posting_time;
+        entries.push_back({run_id, "Interest", savings[i]->account_number, run_tag, out[i]});
+    }
+
+    auto rollback = [&]()
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            if (out[i] == 0)
+                continue;
+            savings[i]->balance = old_balances[i];
+            savings[i]->last_transaction = old_last_transaction[i];
+        }
+        remove("Interest_run.pending"); // Before the records, so a crash here still reads as not committed
+        remove("Bank_Record.csv.tmp");
+    };
+
+    // Stamped records first, then the pending batch: recovery only finishes a run whose stamp made it
+    // into Bank_Record.csv
+    bool staged = writeAccountsFile("Bank_Record.csv.tmp", "#run,interest," + to_string(static_cast<long long>(run_id)));
+    if (staged)
+    {
+        ofstream pending("Interest_run.pending");
+        pending << "run," << static_cast<long long>(run_id) << "\n";
+        appendLedgerEntries(entries, pending);
+        pending.close();
+        staged = !pending.fail();
+    }
+    if (!staged || !replaceFile("Bank_Record.csv.tmp", "Bank_Record.csv")) // Commit point
+    {
+        rollback();
+        setConsoleColor(12);
+        cout << "\n\tError: Interest run could not be saved, no balances were changed.";
+        setConsoleColor(7);
+        return 0;
+    }
+
+    commitVersions(credited.data(), credited.size()); // Snapshot readers see the whole run at once
+
+    ofstream ledger("Transaction_log.csv", ios::app);
+    appendLedgerEntries(entries, ledger);
+    ledger.close();
+    transactionLedger.insert(transactionLedger.end(), entries.begin(), entries.end());
+    for (const LedgerEntry &entry : entries)
+        publishLedgerEntry(entry);
+
+    InterestConfig committed = config;
+    committed.last_run = run_id;
+    saveInterestConfig(committed);
+    remove("Interest_run.pending");
+    return entries.size();
+}
+
+
+void Bank::runScheduledInterest()
+{
+    InterestConfig config = loadInterestConfig();
+    time_t now = time(0);
+    time_t period = 365 * 86400 / config.postings_per_year;
+    if (config.last_run == 0)
+    {
+        // First start with interest enabled: begin the schedule now rather than back-paying
+        config.last_run = now;
+        saveInterestConfig(config);
+        return;
+    }
+    if (now - config.last_run >= period)
+    {
+        postInterest(config, now);
+    }
+}
+
+// Runs every standing order due by 'now' as one batch. Each order goes through transfer(), so it
+// meets the same account, balance and velocity checks as a teller transfer; an order that fails
+// keeps its schedule. The batch commits like an interest run: the stamped records are written, its
+// ledger lines and journal records are staged in Standing_orders.pending, Bank_Record.csv is
+// swapped in (the commit point), then both logs are appended. recoverStandingOrderRun finishes a run that crashed after the commit.
+bool Bank::runDueStandingOrders(time_t now, size_t &executed, size_t &failed)
+{
+    executed = failed = 0;
+    vector<uint32_t> due;
+    standingOrders.collectDue(now, due);
+    if (due.empty())
+        return true;
+
+    struct Saved
+    {
+        AccountNode *account;
+        string balance, last_transaction;
+    };
+    vector<Saved> saved; // State before each transfer, undone in reverse if the batch cannot commit
+    vector<int> statuses(due.size());
+    vector<LedgerEntry> entries;
+    vector<VelocityMonitor::SavedWindows> velocity_saved; // Admissions to undo along with the balances
+    size_t ledger_mark = transactionLedger.size(), history_mark = transactionHistory.size();
+
+    // Both parties of every due order, resolved in one batched pass (even = sender, odd = recipient)
+    vector<string> parties;
+    parties.reserve(2 * due.size());
+    for (uint32_t id : due)
+    {
+        parties.push_back(standingOrders.order(id).from);
+        parties.push_back(standingOrders.order(id).to);
+    }
+    vector<AccountNode *> accounts(parties.size());
+    findAccounts(parties.data(), parties.size(), accounts.data());
+
+    ledgerBatch = &entries;
+    velocityMonitor.checkpoint = &velocity_saved;
+    for (size_t i = 0; i < due.size(); i++)
+    {
+        const StandingOrder &order = standingOrders.order(due[i]);
+        AccountNode *from = accounts[2 * i], *to = accounts[2 * i + 1];
+        if (from != nullptr && to != nullptr)
+        {
+            saved.push_back({from, from->balance, from->last_transaction});
+            saved.push_back({to, to->balance, to->last_transaction});
+        }
+        TxnStatus status = transferBetween(from, to, order.from, order.to, order.amount);
+        statuses[i] = static_cast<int>(status);
+        if (status == TxnStatus::Ok)
+            executed++;
+        else
+            failed++;
+    }
+    ledgerBatch = nullptr;
+    velocityMonitor.checkpoint = nullptr;
+
+    string records = standingOrders.runRecords(due, statuses, now);
+    if (executed == 0)
+    {
+        // No money moved: only the schedules advance
+        if (!standingOrders.appendJournal(records))
+        {
+            standingOrders.requeue(due);
+            return false;
+        }
+        standingOrders.finishRun(due, statuses, now);
+        return true;
+    }
+
+    auto fileSize = [](const string &path)
+    {
+        error_code error;
+        uintmax_t size = filesystem::file_size(path, error);
+        return error ? 0 : static_cast<unsigned long long>(size);
+    };
+    const string &journal = standingOrders.journal();
+    ostringstream ledger_lines;
+    appendLedgerEntries(entries, ledger_lines);
+    // Stamped records first, then the pending batch, as in postInterest
+    unsigned long long run_stamp = static_cast<unsigned long long>(chrono::system_clock::now().time_since_epoch().count());
+    bool staged = writeAccountsFile("Bank_Record.csv.tmp", "#run,standing," + to_string(run_stamp));
+    if (staged)
+    {
+        ofstream pending("Standing_orders.pending", ios::binary);
+        pending << "run," << fileSize("Transaction_log.csv") << "," << fileSize(journal) << "," << entries.size() << ","
+                << run_stamp << "\n" << ledger_lines.str() << records;
+        pending.close();
+        staged = !pending.fail();
+    }
+    if (!staged || !replaceFile("Bank_Record.csv.tmp", "Bank_Record.csv")) // Commit point
+    {
+        vector<AccountNode *> restored;
+        for (auto it = saved.rbegin(); it != saved.rend(); ++it)
+        {
+            it->account->balance = it->balance;
+            it->account->last_transaction = it->last_transaction;
+            restored.push_back(it->account);
+        }
+        commitVersions(restored.data(), restored.size());
+        velocityMonitor.restore(velocity_saved);
+        transactionLedger.resize(ledger_mark);
+        transactionHistory.resize(history_mark);
+        standingOrders.requeue(due);
+        remove("Standing_orders.pending");
+        remove("Bank_Record.csv.tmp");
+        executed = 0;
+        failed = due.size();
+        return false;
+    }
+
+    ofstream ledger("Transaction_log.csv", ios::app | ios::binary);
+    ledger << ledger_lines.str();
+    ledger.close();
+    standingOrders.appendJournal(records);
+    standingOrders.finishRun(due, statuses, now);
+    remove("Standing_orders.pending");
+    return true;
+}
+
+
+
+void Bank::manageInterestPosting()
+{
+    displayAppTitle();
+    cout << "\n\t\tINTEREST POSTING (SAVING ACCOUNTS)\n";
+
+    InterestConfig config = loadInterestConfig();
+    cout << "\n\tAnnual Rate: " << config.annual_rate_bp / 100 << "." << setfill('0') << setw(2) << config.annual_rate_bp % 100
+         << setfill(' ') << "%";
+    cout << "\n\tPostings per Year: " << config.postings_per_year;
+    if (config.last_run != 0)
+    {
+        string last_run = ctime(&config.last_run);
+        last_run.erase(remove(last_run.begin(), last_run.end(), '\n'), last_run.end());
+        cout << "\n\tLast Posting: " << last_run;
+    }
+
+    int choice;
+    cout << "\n\n\t1. Change Annual Rate\n\t2. Change Postings per Year\n\t3. Post Interest Now\n\t4. Return to Employee Menu\n\tChoice: ";
+    while (!(cin >> choice) || choice < 1 || choice > 4) {
+        setConsoleColor(12);
+        cout << "\n\tInvalid choice. Please enter a number between 1 and 4: ";
+        setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    if (choice == 1)
+    {
+        long long rate;
+        cout << "\n\tEnter annual rate in basis points (e.g. 350 for 3.50%): ";
+        while (!(cin >> rate) || rate < 0 || rate > 10000) {
+            setConsoleColor(12);
+            cout << "\n\tInvalid rate. Please enter a value between 0 and 10000: ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        config.annual_rate_bp = rate;
+        saveInterestConfig(config);
+        manageInterestPosting();
+        return;
+    }
+    else if (choice == 2)
+    {
+        int postings;
+        cout << "\n\tEnter postings per year (1, 4, 12 or 365): ";
+        while (!(cin >> postings) || (postings != 1 && postings != 4 && postings != 12 && postings != 365)) {
+            setConsoleColor(12);
+            cout << "\n\tInvalid value. Please enter 1, 4, 12 or 365: ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        config.postings_per_year = postings;
+        saveInterestConfig(config);
+        manageInterestPosting();
+        return;
+    }
+    else if (choice == 3)
+    {
+        auto started = chrono::steady_clock::now();
+        size_t credited = postInterest(config, time(0));
+        auto elapsed_ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started).count();
+        setConsoleColor(10);
+        cout << "\n\tInterest credited to " << credited << " Saving account(s) in " << elapsed_ms << " ms.";
+        setConsoleColor(7);
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    showEmployeeMenu();
+}
+
+// Customer screen: list, add and cancel the standing orders paid from one account
+void Bank::manageStandingOrders()
+{
+    displayAppTitle();
+    cout << "\n\t\tSTANDING ORDERS\n";
+
+    string acc_no;
+    cout << "\n\tEnter Your Account Number: ";
+    cin >> acc_no;
+    if (findAccount(acc_no) == nullptr)
+    {
+        setConsoleColor(12);
+        cout << "\n\tAccount Doesn't Exist!";
+        setConsoleColor(7);
+        cout << "\n\n\tPress any key to return to menu...";
+        readKey();
+        showCustomerMenu();
+        return;
+    }
+
+    static const char *repeat_names[] = {"Once", "Daily", "Weekly", "Monthly"};
+    static const long long repeat_periods[] = {0, 86400, 7 * 86400, 30 * 86400};
+    vector<const StandingOrder *> orders = standingOrders.ordersFrom(acc_no);
+    if (orders.empty())
+        cout << "\n\tNo standing orders from this account.";
+    else
+    {
+        cout << "\n\t" << left << setw(8) << "ID" << setw(14) << "To" << setw(14) << "Amount" << setw(10) << "Repeat"
+             << setw(28) << "Next Run" << "Last Run";
+        for (const StandingOrder *order : orders)
+        {
+            const char *repeat = "Custom";
+            for (int r = 0; r < 4; r++)
+            {
+                if (repeat_periods[r] == order->period)
+                    repeat = repeat_names[r];
+            }
+            cout << "\n\t" << setw(8) << order->id << setw(14) << order->to << setw(14) << formatPaise(order->amount) << setw(10)
+                 << repeat << setw(28) << formatDateTime(static_cast<time_t>(order->due))
+                 << (order->last_status < 0 ? "-" : txnStatusMessage(static_cast<TxnStatus>(order->last_status)));
+        }
+        cout << right;
+    }
+
+    int choice;
+    cout << "\n\n\t1. New Standing Order\n\t2. Cancel a Standing Order\n\t3. Return to Customer Menu\n\tChoice: ";
+    while (!(cin >> choice) || choice < 1 || choice > 3) {
+        setConsoleColor(12);
+        cout << "\n\tInvalid choice. Please enter 1, 2, or 3: ";
+        setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    if (choice == 1)
+    {
+        string to_acc_no;
+        float amount;
+        int start_days, repeat;
+        cout << "\n\tEnter Recipient Account Number: ";
+        cin >> to_acc_no;
+        if (findAccount(to_acc_no) == nullptr || to_acc_no == acc_no)
+        {
+            setConsoleColor(12);
+            cout << (to_acc_no == acc_no ? "\n\tCannot transfer to the same account!" : "\n\tRecipient Account Doesn't Exist!");
+            setConsoleColor(7);
+        }
+        else
+        {
+            cout << "\n\tEnter Amount to Transfer: Rs ";
+            while (!(cin >> amount) || amount <= 0) {
+                setConsoleColor(12);
+                cout << "\n\tInvalid amount. Please enter a positive number: Rs ";
+                setConsoleColor(7);
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            }
+            cout << "\n\tFirst transfer in how many days (0 = now): ";
+            while (!(cin >> start_days) || start_days < 0 || start_days > 3650) {
+                setConsoleColor(12);
+                cout << "\n\tInvalid value. Please enter a number of days between 0 and 3650: ";
+                setConsoleColor(7);
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            }
+            cout << "\n\tRepeat: 1. Once  2. Daily  3. Weekly  4. Monthly (every 30 days)\n\tChoice: ";
+            while (!(cin >> repeat) || repeat < 1 || repeat > 4) {
+                setConsoleColor(12);
+                cout << "\n\tInvalid choice. Please enter a number between 1 and 4: ";
+                setConsoleColor(7);
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            }
+
+            time_t now = time(0);
+            unsigned long long id = standingOrders.add(acc_no, to_acc_no, llround(amount * 100.0), now + start_days * 86400LL,
+                                                       repeat_periods[repeat - 1]);
+            if (id == 0)
+            {
+                setConsoleColor(12);
+                cout << "\n\tError: Could not save the standing order, please try again.";
+                setConsoleColor(7);
+            }
+            else
+            {
+                setConsoleColor(10);
+                cout << "\n\tStanding order " << id << " created.";
+                setConsoleColor(7);
+                size_t executed, failed;
+                if (start_days == 0 && runDueStandingOrders(now, executed, failed) && executed > 0)
+                    cout << "\n\tFirst transfer made now. Your New Balance: Rs " << findAccount(acc_no)->balance;
+                else if (start_days == 0)
+                    cout << "\n\tThe first transfer could not be made now, it will be retried on the next run.";
+            }
+        }
+    }
+    else if (choice == 2)
+    {
+        unsigned long long id;
+        cout << "\n\tEnter Standing Order ID: ";
+        while (!(cin >> id)) {
+            setConsoleColor(12);
+            cout << "\n\tInvalid ID. Please enter a number: ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        bool owned = any_of(orders.begin(), orders.end(), [id](const StandingOrder *order) { return order->id == id; });
+        if (owned && standingOrders.cancel(id))
+        {
+            setConsoleColor(10);
+            cout << "\n\tStanding order " << id << " cancelled.";
+        }
+        else
+        {
+            setConsoleColor(12);
+            cout << (owned ? "\n\tError: Could not save the cancellation, please try again." : "\n\tNo such standing order on this account.");
+        }
+        setConsoleColor(7);
+    }
+    else
+    {
+        showCustomerMenu();
+        return;
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    showCustomerMenu();
+}
+
+
+// Employee screen: run the due standing orders now and benchmark the timing wheel
+void Bank::manageStandingOrderRuns()
+{
+    displayAppTitle();
+    cout << "\n\t\tSTANDING ORDERS\n";
+    cout << "\n\tPending Standing Orders: " << standingOrders.size();
+
+    int choice;
+    cout << "\n\n\t1. Run Due Orders Now\n\t2. Timing Wheel Benchmark\n\t3. Return to Employee Menu\n\tChoice: ";
+    while (!(cin >> choice) || choice < 1 || choice > 3) {
+        setConsoleColor(12);
+        cout << "\n\tInvalid choice. Please enter 1, 2, or 3: ";
+        setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    if (choice == 1)
+    {
+        size_t executed, failed;
+        auto started = chrono::steady_clock::now();
+        bool committed = runDueStandingOrders(time(0), executed, failed);
+        auto elapsed_ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started).count();
+        if (!committed)
+        {
+            setConsoleColor(12);
+            cout << "\n\tError: The run could not be saved, no balances were changed.";
+        }
+        else
+        {
+            setConsoleColor(10);
+            cout << "\n\tTransfers made: " << executed << ", failed checks: " << failed << " (" << elapsed_ms << " ms).";
+        }
+        setConsoleColor(7);
+    }
+    else if (choice == 2)
+    {
+        runTimingWheelBenchmark();
+        manageStandingOrderRuns();
+        return;
+    }
+    else
+    {
+        showEmployeeMenu();
+        return;
+    }
+
+    cout << "\n\n\tPress any key to return to menu...";
+    readKey();
+    manageStandingOrderRuns();
+}
+
+
+// Timing wheel costs on an in-memory book: insert millions of orders spread over 90 days, cancel a
+// quarter of them, then advance the clock through the 90 days firing (and rescheduling) the rest.
+void runTimingWheelBenchmark()
+{
+    displayAppTitle();
+    cout << "\n\t\tTIMING WHEEL BENCHMARK\n";
+
+    const size_t ORDERS = 2000000;
+    const long long DAYS = 90;
+    StandingOrderBook book;
+    long long start = time(0);
+    book.reset(start, ""); // No journal
+    mt19937_64 rng(46);
+    uniform_int_distribution<long long> offset(1, DAYS * 86400);
+    static const long long periods[] = {0, 86400, 7 * 86400, 30 * 86400};
+
+    auto started = chrono::steady_clock::now();
+    vector<unsigned long long> ids(ORDERS);
+    for (size_t i = 0; i < ORDERS; i++)
+        ids[i] = book.add("1000000000", "2000000000", 100, start + offset(rng), periods[i % 4]);
+    double insert_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - started).count() / ORDERS;
+    size_t memory = book.memoryBytes();
+
+    shuffle(ids.begin(), ids.end(), rng);
+    started = chrono::steady_clock::now();
+    for (size_t i = 0; i < ORDERS / 4; i++)
+        book.cancel(ids[i]);
+    double cancel_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - started).count() / (ORDERS / 4);
+
+    size_t fired = 0;
+    vector<uint32_t> due;
+    started = chrono::steady_clock::now();
+    for (long long hour = 1; hour <= DAYS * 24; hour++)
+    {
+        due.clear();
+        book.collectDue(start + hour * 3600, due);
+        book.finishRun(due, vector<int>(due.size(), 0), start + hour * 3600);
+        fired += due.size();
+    }
+    double advance_s = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+    cout << fixed << setprecision(1);
+    cout << "\n\tOrders: " << ORDERS << " over " << DAYS << " days, pool " << memory / (1024 * 1024) << " MB";
+    cout << "\n\tInsert: " << insert_ns << " ns per order";
+    cout << "\n\tCancel: " << cancel_ns << " ns per order";
+    cout << "\n\tAdvance " << DAYS << " days hour by hour: " << fired << " runs in " << setprecision(3) << advance_s << " s ("
+         << setprecision(1) << (fired ? advance_s * 1e9 / fired : 0) << " ns per run)";
+    cout << "\n\tStill pending: " << book.size();
+    cout << defaultfloat << setprecision(6);
+    cout << "\n\n\tPress any key to return...";
+    readKey();
+}
+
+
+
+// Server mode protocol (one request per line, one reply per line, "OK ..." or "ERR ..."):
+//   LOGIN <acc_no> <password>     TOKEN <token>          BALANCE
+//   SEARCH <acc_no>               DEPOSIT <amount>       WITHDRAW <amount>
+//   TRANSFER <to_acc_no> <amount> SERVICE <1-4> <description>
+//   HISTORY                       QUIT
+// DEPOSIT, WITHDRAW and TRANSFER take an optional trailing idempotency key: a retry with the same
+// key (per account) gets the original reply without moving the money again.
+// LOGIN is answered by the event loop once the worker pool has checked the password; its reply
+// ends with "TOKEN <token>", and TOKEN <token> logs any connection in as that account without a
+// second password check until the token expires.
+string Bank::dispatchServerCommand(string &session_account, const string &line, bool &modified, bool &quit)
+{
+    istringstream request(line);
+    string command;
+    request >> command;
+    transform(command.begin(), command.end(), command.begin(), ::toupper);
+
+    if (command == "TOKEN")
+    {
+        string token;
+        request >> token;
+        const string *account = sessionTokens.find(token, time(0));
+        if (account == nullptr)
+            return "ERR Invalid or expired token";
+        session_account = *account;
+        return "OK Login Successful!";
+    }
+    if (command == "QUIT")
+    {
+        quit = true;
+        return "OK Bye";
+    }
+    if (session_account.empty())
+        return "ERR Please LOGIN first";
+
+    if (command == "BALANCE")
+    {
+        AccountNode *account = findAccount(session_account);
+        return account == nullptr ? "ERR Account Doesn't Exist!" : "OK " + formatPaise(parseAmountToPaise(account->balance));
+    }
+    if (command == "HISTORY")
+    {
+        // Latest 10 ledger entries touching the session account, newest first
+        string reply = "OK";
+        int shown = 0;
+        for (auto it = transactionLedger.rbegin(); it != transactionLedger.rend() && shown < 10; ++it)
+        {
+            if (it->account != session_account && it->counterparty != session_account)
+                continue;
+            reply += " " + to_string(static_cast<long long>(it->timestamp)) + ":" + it->kind + ":" + it->account + ":" +
+                     it->counterparty + ":" + formatPaise(it->amount) + ";";
+            shown++;
+        }
+        return reply;
+    }
+    if (command == "SEARCH")
+    {
+        string acc_no;
+        request >> acc_no;
+        AccountNode *account = findAccount(acc_no);
+        if (account == nullptr)
+            return "ERR Account Doesn't Exist!";
+        return "OK " + account->account_number + "|" + account->name + "|" + account->acc_type + "|" +
+               account->balance + "|" + account->last_transaction;
+    }
+    if (command == "DEPOSIT" || command == "WITHDRAW" || command == "TRANSFER")
+    {
+        string to_acc_no, amount, key;
+        if (command == "TRANSFER")
+            request >> to_acc_no;
+        request >> amount >> key;
+
+        string scoped_key = session_account + ":" + key;
+        string fingerprint = command + " " + to_acc_no + " " + amount;
+        time_t now = time(0);
+        if (!key.empty())
+        {
+            bool mismatch;
+            const string *previous = idempotencyKeys.find(scoped_key, fingerprint, now, mismatch);
+            if (previous != nullptr)
+                return *previous;
+            if (mismatch)
+                return "ERR Idempotency key was already used for a different request";
+        }
+
+        long long amount_paise = parseAmountToPaise(amount);
+        TxnStatus status = command == "DEPOSIT"    ? deposit(session_account, amount_paise)
+                           : command == "WITHDRAW" ? withdraw(session_account, amount_paise)
+                                                   : transfer(session_account, to_acc_no, amount_paise);
+        string reply = status == TxnStatus::Ok ? "OK " + findAccount(session_account)->balance
+                                               : string("ERR ") + txnStatusMessage(status);
+        if (status == TxnStatus::Ok)
+            modified = true;
+        if (!key.empty() && status != TxnStatus::StorageError) // Storage errors are worth retrying for real
+            idempotencyKeys.remember(scoped_key, fingerprint, reply, now);
+        return reply;
+    }
+    if (command == "SERVICE")
+    {
+        int service_choice = 0;
+        string request_description;
+        request >> service_choice;
+        getline(request >> ws, request_description);
+        AccountNode *account = findAccount(session_account);
+        if (account == nullptr)
+            return "ERR Account Doesn't Exist!";
+        string assigned_to;
+        size_t position = serviceDesk.submit(service_choice, getCurrentDateTime() + " | Account: " + session_account + " | Name: " + account->name +
+                                                                 " | Type: " + serviceTypeName(service_choice) + " | Desc: " + request_description,
+                                             assigned_to);
+        return "OK " + to_string(position);
+    }
+    return "ERR Unknown command";
+}
+
+
+// Interactive session: the main/login/customer menus of the console application, over a socket.
+// Entered by sending SESSION instead of a protocol command.
+SessionTask Bank::runSession(SessionIO &io)
+{
+    io.write("WELCOME TO THE BANKING SYSTEM\n");
+    while (true)
+    {
+        io.write("\n1. Customer Login\n2. New Customer Registration\n0. Exit\nEnter your choice: ");
+        string choice = co_await io.readLine();
+        if (choice == "1")
+        {
+            string acc_no;
+            co_await sessionLogin(io, acc_no);
+            if (!acc_no.empty())
+                co_await sessionCustomerMenu(io, acc_no);
+        }
+        else if (choice == "2")
+        {
+            co_await sessionCreateAccount(io);
+        }
+        else if (choice == "0")
+        {
+            break;
+        }
+        else
+        {
+            io.write("Invalid choice! Please try again.\n");
+        }
+    }
+    io.write("Thank you for using our banking system!\n");
+}
+
+SessionTask Bank::sessionLogin(SessionIO &io, string &logged_in_account)
+{
+    io.write("\nCUSTOMER LOGIN\nEnter Account Number: ");
+    string acc_no = co_await io.readLine();
+    io.write("Enter Password: ");
+    string password = co_await io.readLine();
+
+    auto credentials = accountCredentials.find(acc_no);
+    bool known = credentials != accountCredentials.end();
+    string stored = known ? credentials->second : unknownUserPasswordHash();
+    auto check = make_shared<PasswordCheck>();
+    function<void()> verify = [check, stored, password]() { *check = checkPassword(stored, password); };
+    co_await io.offload(move(verify));
+
+    if (known && check->valid)
+    {
+        // Store a current hash unless the password changed while this one was checked (it reaches
+        // the file with the next save)
+        credentials = accountCredentials.find(acc_no);
+        if (!check->rehashed.empty() && credentials != accountCredentials.end() && credentials->second == stored)
+            credentials->second = check->rehashed;
+        io.write("Login Successful!\n");
+        logged_in_account = acc_no;
+    }
+    else
+    {
+        io.write("Invalid Account Number or Password!\n");
+    }
+}
+
+SessionTask Bank::sessionCustomerMenu(SessionIO &io, const string &acc_no)
+{
+    while (true)
+    {
+        io.write("\nCUSTOMER MENU\n1. Check Balance\n2. Transfer Funds\n3. Log Out\nEnter your choice: ");
+        string choice = co_await io.readLine();
+        if (choice == "1")
+        {
+            AccountNode *account = findAccount(acc_no);
+            io.write(account == nullptr ? string("Account Doesn't Exist!\n") : "Current Balance: Rs " + account->balance + "\n");
+        }
+        else if (choice == "2")
+        {
+            co_await sessionTransfer(io, acc_no);
+        }
+        else if (choice == "3")
+        {
+            co_return;
+        }
+        else
+        {
+            io.write("Invalid choice! Please try again.\n");
+        }
+    }
+}
+
+SessionTask Bank::sessionCreateAccount(SessionIO &io)
+{
+    io.write("\nACCOUNT CREATION\n");
+    string acc_no;
+    while (true)
+    {
+        io.write("Enter Account Number: ");
+        acc_no = co_await io.readLine();
+        if (const char *problem = accountFieldError(acc_no))
+            io.write(string(problem) + "\n");
+        else if (accountCredentials.count(acc_no))
+            io.write("Account No. " + acc_no + " already exists!\n");
+        else
+            break;
+    }
+    // Same checks as the console form: every field goes into a CSV record
+    const char *prompts[] = {"Enter Name: ", "Enter Date of Birth (DD/MM/YYYY): ", "Enter Age: ",
+                             "Enter Address (single line): ", "Enter Phone Number: "};
+    string fields[5];
+    for (int i = 0; i < 5; i++)
+    {
+        io.write(prompts[i]);
+        fields[i] = co_await io.readLine();
+        while (const char *problem = accountFieldError(fields[i]))
+        {
+            io.write(string(problem) + "\n" + prompts[i]);
+            fields[i] = co_await io.readLine();
+        }
+    }
+    const string &name = fields[0], &dob = fields[1], &age = fields[2], &address = fields[3], &phone = fields[4];
+    io.write("Enter initial deposit (0 for none): Rs ");
+    long long deposit_paise = max(0LL, parseAmountToPaise(co_await io.readLine()));
+    io.write("Select Type of Account (1. Saving, 2. Current): ");
+    string acc_type = (co_await io.readLine()) == "1" ? "Saving" : "Current";
+    io.write("Enter a Password for your Account: ");
+    string password = co_await io.readLine();
+    auto credential = make_shared<string>();
+    function<void()> hash = [credential, password]() { *credential = hashPassword(password); };
+    co_await io.offload(move(hash));
+
+    // The account number may have been taken by another session while this one was suspended
+    if (!openAccount(acc_no, name, dob, age, address, phone, formatPaise(deposit_paise), acc_type, *credential))
+    {
+        io.write("Account No. " + acc_no + " already exists!\n");
+        co_return;
+    }
+    co_await io.durable();
+    io.write("Account created successfully! Account Number: " + acc_no + ", Initial Balance: Rs " + formatPaise(deposit_paise) + "\n");
+}
+
+SessionTask Bank::sessionTransfer(SessionIO &io, const string &from_acc_no)
+{
+    io.write("\nFUND TRANSFER\nEnter Recipient Account Number: ");
+    string to_acc_no = co_await io.readLine();
+    io.write("Enter Amount to Transfer: Rs ");
+    long long amount = parseAmountToPaise(co_await io.readLine());
+
+    TxnStatus status = transfer(from_acc_no, to_acc_no, amount);
+    if (status != TxnStatus::Ok)
+    {
+        io.write(string(txnStatusMessage(status)) + "\n");
+        co_return;
+    }
+    co_await io.durable(); // Only confirm once the new balances are on disk
+    AccountNode *from_account = findAccount(from_acc_no);
+    io.write("Transfer Successful! Your New Balance: Rs " + (from_account ? from_account->balance : string("?")) + "\n");
+}
+
+
+#ifdef __linux__
+// Per-connection state for the server event loop
+struct ServerConnection
+{
+    static constexpr size_t MAX_INPUT_BYTES = 64 * 1024; // Longest line (or backlog while verifying) accepted
+    string input;   // Bytes received but not yet forming a full line
+    string output;  // Replies not yet accepted by the socket
+    string account; // Logged-in account, empty before LOGIN
+    const BalanceCell *balance = nullptr; // Logged-in account's balance, read without bank_mutex
+    bool closing = false;
+    bool watching_output = false; // Registered for EPOLLOUT because output is pending
+    unique_ptr<SessionIO> io;     // Set once the client switches to an interactive SESSION
+    SessionTask session;
+    unsigned long long serial = 0; // Tells a reused fd apart when pooled password work finishes
+    bool verifying = false;        // LOGIN waiting for the password workers; later lines wait too
+    string login_account;
+    string login_stored;                 // Stored credential the password is being checked against
+    shared_ptr<PasswordCheck> login_check;
+};
+
+// Password work finished for one event loop thread: the workers post (fd, serial) and wake the
+// loop through its eventfd. Shared with the queued jobs, which may outlive the loop.
+struct PasswordCompletions
+{
+    int wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    mutex lock;
+    vector<pair<int, unsigned long long>> done;
+
+    ~PasswordCompletions() { close(wake_fd); }
+
+    void post(int fd, unsigned long long serial)
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            done.emplace_back(fd, serial);
+        }
+        uint64_t one = 1;
+        ssize_t written = write(wake_fd, &one, sizeof(one));
+        (void)written; // The counter only fails to grow if it is about to overflow; the loop wakes anyway
+    }
+};
+
+// State shared by all server threads. The Bank and the global credential/queue structures are
+// only touched while bank_mutex is held; the threads overlap on socket I/O.
+struct ServerState
+{
+    mutex bank_mutex;
+    atomic<bool> running{true};
+    atomic<size_t> accepted{0};
+    atomic<size_t> requests{0};
+    bool modified = false;                          // Unsaved changes (guarded by bank_mutex)
+    chrono::steady_clock::time_point last_save;     // Guarded by bank_mutex
+
+    // Replica state
+    bool read_only = false;                         // Rejects writes until promoted (guarded by bank_mutex)
+    atomic<bool> primary_connected{false};
+    atomic<size_t> applied_seq{0};                  // Last replication record applied
+    atomic<long long> last_lag_us{0};               // Commit-to-apply delay of that record
+    atomic<long long> max_lag_us{0};
+};
+
+// Open a TCP socket listening on 127.0.0.1:port, -1 on failure
+static int openListeningSocket(unsigned short port, bool non_blocking)
+{
+    int listen_fd = socket(AF_INET, SOCK_STREAM | (non_blocking ? SOCK_NONBLOCK : 0), 0);
+    if (listen_fd < 0)
+        return -1;
+    int reuse = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(listen_fd, SOMAXCONN) < 0)
+    {
+        close(listen_fd);
+        return -1;
+    }
+    return listen_fd;
+}
+
+// Blocking connect to 127.0.0.1:port, -1 on failure
+static int connectLoopback(unsigned short port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    if (fd >= 0)
+    {
+        int no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+    }
+    return fd;
+}
+
+// Send the whole buffer on a blocking socket
+static bool sendAll(int fd, const string &data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+            return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Allow thousands of sockets (the default soft limit is often 1024)
+static void raiseOpenFileLimit()
+{
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+// One server thread: every socket is non-blocking and epoll reports which ones are ready, so an
+// idle or slow client never holds up the others. Session coroutines are resumed on the thread
+// that owns their connection; sessions waiting for durability are resumed after one shared save.
+void Bank::serverEventLoop(int listen_fd, bool watch_stdin, ServerState &state)
+{
+    int epoll_fd = epoll_create1(0);
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLEXCLUSIVE; // Wake only one thread per incoming connection
+    event.data.fd = listen_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+    if (watch_stdin)
+    {
+        event.events = EPOLLIN;
+        event.data.fd = STDIN_FILENO;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, STDIN_FILENO, &event);
+    }
+
+    unordered_map<int, ServerConnection> connections;
+    vector<epoll_event> ready(1024);
+    vector<int> durable_waiters;
+    vector<int> offload_waiters; // Sessions whose password work the workers refused
+    unsigned long long next_serial = 0;
+
+    auto completions = make_shared<PasswordCompletions>();
+    event.events = EPOLLIN;
+    event.data.fd = completions->wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, completions->wake_fd, &event);
+
+    auto closeConnection = [&](int fd)
+    {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+    };
+    // Write as much pending output as the socket takes; watch for EPOLLOUT only while some remains
+    auto flushConnection = [&](int fd, ServerConnection &connection)
+    {
+        size_t sent = 0;
+        while (sent < connection.output.size())
+        {
+            ssize_t n = send(fd, connection.output.data() + sent, connection.output.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+                break;
+            sent += static_cast<size_t>(n);
+        }
+        connection.output.erase(0, sent);
+        if (connection.output.empty() && connection.closing)
+        {
+            closeConnection(fd);
+            return;
+        }
+        bool pending = !connection.output.empty();
+        if (pending != connection.watching_output)
+        {
+            epoll_event update{};
+            update.events = pending ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+            update.data.fd = fd;
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &update);
+            connection.watching_output = pending;
+        }
+    };
+    // Queue password work for a connection; the loop hears back through 'completions'
+    auto offload = [&](int fd, const ServerConnection &connection, const function<void()> &work)
+    {
+        shared_ptr<PasswordCompletions> notify = completions;
+        unsigned long long serial = connection.serial;
+        return passwordWorkers.trySubmit([work, notify, fd, serial]()
+        {
+            work();
+            notify->post(fd, serial);
+        });
+    };
+    // Resume a session suspended on input or durability (bank_mutex held) and collect its output
+    auto resumeSession = [&](int fd, ServerConnection &connection)
+    {
+        SessionIO &io = *connection.io;
+        if (io.waiting && !io.awaiting_durable && !io.awaiting_offload && !io.lines.empty())
+        {
+            coroutine_handle<> h = io.waiting;
+            io.waiting = nullptr;
+            h.resume();
+        }
+        if (io.offloaded) // The session is waiting for password work
+        {
+            function<void()> work = move(io.offloaded);
+            io.offloaded = nullptr;
+            if (!offload(fd, connection, work))
+            {
+                io.offloaded = move(work); // Workers saturated: keep it and try again on the next pass
+                offload_waiters.push_back(fd);
+            }
+        }
+        connection.output += io.output;
+        io.output.clear();
+        if (io.awaiting_durable)
+            durable_waiters.push_back(fd);
+        if (connection.session.done())
+            connection.closing = true;
+    };
+    // Answer a LOGIN whose password check has finished (bank_mutex held)
+    auto finishLogin = [&](ServerConnection &connection)
+    {
+        connection.verifying = false;
+        PasswordCheck &check = *connection.login_check;
+        auto credentials = accountCredentials.find(connection.login_account);
+        if (!check.valid || credentials == accountCredentials.end())
+        {
+            connection.output += "ERR Invalid Account Number or Password!\n";
+            return;
+        }
+        if (!check.rehashed.empty() && credentials->second == connection.login_stored)
+        {
+            credentials->second = check.rehashed; // Plaintext or an old cost: store a current hash
+            state.modified = true;
+        }
+        connection.account = connection.login_account;
+        connection.output += "OK Login Successful! TOKEN " + sessionTokens.issue(connection.account, time(0)) + "\n";
+        // A replica may drop its whole book on resync, so only a primary hands out cells
+        connection.balance = state.read_only ? nullptr : balanceCell(connection.account);
+    };
+    // Run the complete lines received so far; stops early while a LOGIN is being verified
+    auto processInput = [&](int fd, ServerConnection &connection)
+    {
+        // Taken on the first line that needs the book; BALANCE alone never takes it
+        unique_lock<mutex> lock(state.bank_mutex, defer_lock);
+        size_t line_start = 0, line_end;
+        while (!connection.closing && !connection.verifying && (line_end = connection.input.find('\n', line_start)) != string::npos)
+        {
+            string line = connection.input.substr(line_start, line_end - line_start);
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            line_start = line_end + 1;
+            state.requests++;
+
+            if (!connection.io && connection.balance != nullptr && line == "BALANCE")
+            {
+                long long paise;
+                string last_activity;
+                connection.balance->read(paise, last_activity);
+                connection.output += "OK " + formatPaise(paise) + "\n";
+                continue;
+            }
+            if (!lock.owns_lock())
+                lock.lock();
+
+            if (connection.io)
+            {
+                connection.io->lines.push_back(move(line));
+            }
+            else if (line == "LAG")
+            {
+                connection.output += "OK applied=" + to_string(state.applied_seq) + " last_lag_us=" + to_string(state.last_lag_us) +
+                                     " max_lag_us=" + to_string(state.max_lag_us) +
+                                     (state.read_only ? (state.primary_connected ? " primary=connected\n" : " primary=lost\n") : " role=primary\n");
+            }
+            else if (line == "PROMOTE")
+            {
+                if (!state.read_only)
+                    connection.output += "ERR Not a replica\n";
+                else if (state.primary_connected)
+                    connection.output += "ERR Primary is still connected\n";
+                else
+                {
+                    // Take over: persist the replicated state as this directory's book
+                    state.read_only = false;
+                    saveAccountsToFile();
+                    saveAllCredentials();
+                    saveTransactionLedger();
+                    connection.output += "OK Promoted to primary\n";
+                }
+            }
+            else if (state.read_only && (line == "SESSION" || line.compare(0, 7, "DEPOSIT") == 0 || line.compare(0, 8, "WITHDRAW") == 0 ||
+                                         line.compare(0, 8, "TRANSFER") == 0 || line.compare(0, 7, "SERVICE") == 0))
+            {
+                connection.output += "ERR Read-only replica\n";
+            }
+            else if (line == "SESSION")
+            {
+                connection.io.reset(new SessionIO());
+                connection.session = runSession(*connection.io);
+                connection.session.start(); // Runs until the first prompt
+            }
+            else
+            {
+                istringstream request(line);
+                string command, acc_no, password;
+                request >> command >> acc_no >> password;
+                transform(command.begin(), command.end(), command.begin(), ::toupper);
+                if (command == "LOGIN")
+                {
+                    // Unknown accounts are checked against a dummy hash so they cost the same
+                    auto credentials = accountCredentials.find(acc_no);
+                    bool known = credentials != accountCredentials.end();
+                    string stored = known ? credentials->second : unknownUserPasswordHash();
+                    auto check = make_shared<PasswordCheck>();
+                    if (offload(fd, connection, [check, stored, password, known]()
+                    {
+                        *check = checkPassword(stored, password);
+                        check->valid = check->valid && known;
+                    }))
+                    {
+                        connection.verifying = true;
+                        connection.login_account = acc_no;
+                        connection.login_stored = stored;
+                        connection.login_check = check;
+                    }
+                    else
+                        connection.output += "ERR Server busy, try again\n";
+                    continue;
+                }
+                connection.output += dispatchServerCommand(connection.account, line, state.modified, connection.closing);
+                connection.output += '\n';
+                if (command == "TOKEN")
+                    connection.balance = connection.account.empty() || state.read_only ? nullptr : balanceCell(connection.account);
+            }
+        }
+        connection.input.erase(0, line_start);
+        if (connection.io)
+        {
+            if (!lock.owns_lock())
+                lock.lock();
+            resumeSession(fd, connection);
+        }
+    };
+
+    while (state.running)
+    {
+        int count = epoll_wait(epoll_fd, ready.data(), static_cast<int>(ready.size()), offload_waiters.empty() ? 200 : 10);
+        for (int i = 0; i < count; i++)
+        {
+            int fd = ready[i].data.fd;
+            if (fd == STDIN_FILENO)
+            {
+                char discard[256];
+                if (read(STDIN_FILENO, discard, sizeof(discard)) >= 0)
+                    state.running = false;
+            }
+            else if (fd == completions->wake_fd)
+            {
+                uint64_t counter;
+                ssize_t drained = read(fd, &counter, sizeof(counter));
+                (void)drained;
+                vector<pair<int, unsigned long long>> done;
+                {
+                    lock_guard<mutex> guard(completions->lock);
+                    done.swap(completions->done);
+                }
+                for (const auto &finished : done)
+                {
+                    auto found = connections.find(finished.first);
+                    if (found == connections.end() || found->second.serial != finished.second)
+                        continue; // Closed while its password was being checked
+                    ServerConnection &connection = found->second;
+                    {
+                        lock_guard<mutex> lock(state.bank_mutex);
+                        if (connection.io)
+                        {
+                            SessionIO &io = *connection.io;
+                            io.awaiting_offload = false;
+                            coroutine_handle<> h = io.waiting;
+                            io.waiting = nullptr;
+                            h.resume();
+                            resumeSession(finished.first, connection);
+                        }
+                        else
+                            finishLogin(connection);
+                    }
+                    processInput(finished.first, connection); // Lines that arrived during the check
+                    flushConnection(finished.first, connection);
+                }
+            }
+            else if (fd == listen_fd)
+            {
+                int client_fd;
+                while ((client_fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK)) >= 0)
+                {
+                    int no_delay = 1;
+                    setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+                    epoll_event add{};
+                    add.events = EPOLLIN;
+                    add.data.fd = client_fd;
+                    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_fd, &add);
+                    connections[client_fd].serial = ++next_serial;
+                    state.accepted++;
+                }
+            }
+            else
+            {
+                auto found = connections.find(fd);
+                if (found == connections.end())
+                    continue;
+                ServerConnection &connection = found->second;
+
+                if (ready[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                {
+                    char buffer[4096];
+                    ssize_t n;
+                    bool peer_closed = false;
+                    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+                    {
+                        connection.input.append(buffer, static_cast<size_t>(n));
+                        if (connection.input.size() > ServerConnection::MAX_INPUT_BYTES)
+                        {
+                            processInput(fd, connection); // Make room by running the complete lines
+                            if (connection.input.size() > ServerConnection::MAX_INPUT_BYTES && !connection.closing)
+                            {
+                                connection.output += "ERR Line too long\n";
+                                connection.closing = true;
+                            }
+                        }
+                        if (connection.closing)
+                            connection.input.clear(); // Nothing more will be read from it
+                    }
+                    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+                        peer_closed = true;
+                    if (peer_closed)
+                    {
+                        lock_guard<mutex> lock(state.bank_mutex); // Destroying a session frame may touch shared state
+                        closeConnection(fd);
+                        continue;
+                    }
+                    processInput(fd, connection);
+                }
+                flushConnection(fd, connection);
+            }
+        }
+
+        // Group commit: one save covers every session on this thread waiting for durability
+        lock_guard<mutex> lock(state.bank_mutex);
+        auto now = chrono::steady_clock::now();
+        if (!durable_waiters.empty() || (state.modified && now - state.last_save >= chrono::seconds(5)))
+        {
+            saveAccountsToFile();
+            saveAllCredentials();
+            state.modified = false;
+            state.last_save = now;
+        }
+        vector<int> waiters;
+        waiters.swap(durable_waiters);
+        for (int fd : waiters)
+        {
+            auto found = connections.find(fd);
+            if (found == connections.end() || !found->second.io || !found->second.io->awaiting_durable)
+                continue;
+            SessionIO &io = *found->second.io;
+            io.awaiting_durable = false;
+            coroutine_handle<> h = io.waiting;
+            io.waiting = nullptr;
+            h.resume();
+            resumeSession(fd, found->second); // Collect output, continue with any buffered input
+            flushConnection(fd, found->second);
+        }
+        waiters.clear();
+        waiters.swap(offload_waiters);
+        for (int fd : waiters)
+        {
+            auto found = connections.find(fd);
+            if (found == connections.end() || !found->second.io || !found->second.io->offloaded)
+                continue;
+            resumeSession(fd, found->second); // Submits the password work again
+            flushConnection(fd, found->second);
+        }
+    }
+
+    lock_guard<mutex> lock(state.bank_mutex);
+    for (auto &pair : connections)
+        close(pair.first);
+    connections.clear();
+    close(epoll_fd);
+}
+
+
+// Serves many clients from a fixed number of threads sharing one listening socket. All requests
+// run against this Bank instance; balances go to the ledger immediately and Bank_Record.csv is
+// saved every few seconds (or at once when an interactive session is waiting for it).
+void Bank::runServer(unsigned short port, unsigned worker_threads, unsigned short replication_port, bool watch_stdin)
+{
+    raiseOpenFileLimit();
+
+    int listen_fd = openListeningSocket(port, true);
+    int replication_fd = replication_port != 0 ? openListeningSocket(replication_port, false) : -1;
+    if (listen_fd < 0 || (replication_port != 0 && replication_fd < 0))
+    {
+        setConsoleColor(12);
+        cout << "\n\tError: Could not listen on port " << (listen_fd < 0 ? port : replication_port) << " (" << strerror(errno) << ").";
+        setConsoleColor(7);
+        if (listen_fd >= 0)
+            close(listen_fd);
+        return;
+    }
+
+    setConsoleColor(10);
+    cout << "\n\tServer listening on 127.0.0.1:" << port << " with " << worker_threads << " thread(s).";
+    if (replication_fd >= 0)
+        cout << "\n\tReplicas can follow on port " << replication_port << ".";
+    cout << (watch_stdin ? "\n\tPress Enter to stop.\n" : "\n");
+    setConsoleColor(7);
+    cout.flush();
+
+    ServerState state;
+    state.last_save = chrono::steady_clock::now();
+    unknownUserPasswordHash(); // Built now rather than by the first unknown LOGIN, on a loop thread
+    ReplicationLog log;
+    thread replication_thread;
+    if (replication_fd >= 0)
+    {
+        replicationLog = &log;
+        replication_thread = thread(&Bank::replicationListener, this, replication_fd, ref(state));
+    }
+
+    vector<thread> threads;
+    for (unsigned t = 1; t < worker_threads; t++)
+        threads.emplace_back(&Bank::serverEventLoop, this, listen_fd, false, ref(state));
+    serverEventLoop(listen_fd, watch_stdin, state);
+    for (thread &t : threads)
+        t.join();
+    if (replication_thread.joinable())
+    {
+        replication_thread.join();
+        replicationLog = nullptr;
+        close(replication_fd);
+    }
+    close(listen_fd);
+    if (state.modified)
+    {
+        saveAccountsToFile();
+        saveAllCredentials();
+    }
+
+    setConsoleColor(10);
+    cout << "\n\tServer stopped. Connections accepted: " << state.accepted << ", requests handled: " << state.requests
+         << ", retries answered from idempotency keys: " << idempotencyKeys.replayCount();
+    setConsoleColor(7);
+}
+
+
+// --- Log-shipping replication ---
+// A replica connects to the primary's replication port and receives a snapshot (accounts "A,...",
+// credentials "K,...", ledger history "H,...", then "END,<seq>"), followed by every record the
+// primary commits after that point. It applies them in order and answers read-only queries.
+
+// Primary: accept replicas until the server stops, one sender thread per replica
+void Bank::replicationListener(int listen_fd, ServerState &state)
+{
+    vector<thread> senders;
+    vector<int> replica_fds;
+    while (state.running)
+    {
+        pollfd ready{listen_fd, POLLIN, 0};
+        if (poll(&ready, 1, 200) <= 0)
+            continue;
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        int no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        replica_fds.push_back(fd);
+        senders.emplace_back(&Bank::replicationSender, this, fd, ref(state));
+    }
+    replicationLog->close();
+    for (int fd : replica_fds)
+        shutdown(fd, SHUT_RDWR); // Unblock senders stuck on a slow replica
+    for (thread &sender : senders)
+        sender.join();
+    for (int fd : replica_fds)
+        close(fd);
+}
+
+// Primary: send a consistent snapshot, then stream the log from the snapshot's position
+void Bank::replicationSender(int fd, ServerState &state)
+{
+    string snapshot;
+    size_t from;
+    int follower;
+    {
+        // Writers publish under the same lock, so the snapshot and 'from' line up exactly
+        lock_guard<mutex> lock(state.bank_mutex);
+        vector<AccountNode *> accounts;
+        collectAllAccounts(accounts);
+        for (const AccountNode *node : accounts)
+            snapshot += "A," + accountRecordLine(node) + "\n";
+        for (const auto &pair : accountCredentials)
+            snapshot += "K," + pair.first + "," + pair.second + "\n";
+        for (const LedgerEntry &entry : transactionLedger)
+        {
+            snapshot += "H," + to_string(static_cast<long long>(entry.timestamp)) + "," + entry.kind + "," + entry.account + "," +
+                        entry.counterparty + "," + to_string(entry.amount) + "\n";
+        }
+        follower = replicationLog->follow(from);
+        snapshot += "END," + to_string(from) + "\n";
+    }
+    if (!sendAll(fd, snapshot))
+    {
+        replicationLog->unfollow(follower);
+        return;
+    }
+
+    vector<string> batch;
+    while (state.running)
+    {
+        bool open = replicationLog->waitForRecords(follower, from, batch, chrono::milliseconds(200));
+        if (!batch.empty())
+        {
+            string out;
+            for (const string &record : batch)
+                out += record + "\n";
+            if (!sendAll(fd, out))
+                break;
+            from += batch.size();
+        }
+        if (!open)
+            break;
+    }
+    replicationLog->unfollow(follower);
+}
+
+// Replica: apply everything the primary sends until the connection drops
+void Bank::replicationReceiver(int fd, ServerState &state)
+{
+    string buffer;
+    vector<char> chunk(1 << 16);
+    ssize_t n;
+    while ((n = recv(fd, chunk.data(), chunk.size(), 0)) > 0)
+    {
+        buffer.append(chunk.data(), static_cast<size_t>(n));
+        long long now_us = chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count();
+
+        lock_guard<mutex> lock(state.bank_mutex);
+        size_t start = 0, end;
+        while ((end = buffer.find('\n', start)) != string::npos)
+        {
+            string line = buffer.substr(start, end - start);
+            start = end + 1;
+            if (!line.empty() && isdigit(static_cast<unsigned char>(line[0])))
+            {
+                // Streamed record: <seq>,<commit_time_us>,<payload>
+                size_t first = line.find(','), second = line.find(',', first + 1);
+                if (first == string::npos || second == string::npos)
+                    continue;
+                applyReplicatedPayload(line.substr(second + 1));
+                long long lag = now_us - atoll(line.c_str() + first + 1);
+                state.applied_seq = static_cast<size_t>(atoll(line.c_str()));
+                state.last_lag_us = lag;
+                if (lag > state.max_lag_us)
+                    state.max_lag_us = lag;
+            }
+            else if (line.compare(0, 4, "END,") == 0)
+            {
+                finishReplicatedSnapshot();
+                state.applied_seq = static_cast<size_t>(atoll(line.c_str() + 4));
+            }
+            else
+            {
+                applyReplicatedPayload(line);
+            }
+        }
+        buffer.erase(0, start);
+    }
+    lock_guard<mutex> lock(state.bank_mutex);
+    for (AccountNode *account : snapshotAccounts) // Connection lost before the snapshot's END
+        delete account;
+    snapshotAccounts.clear();
+    state.primary_connected = false;
+}
 
-    string creation_date_time = getCurrentDateTime();
 
-    cout << "\n\tEnter a Password for your Account: ";
-    password = getSecurePasswordInput();
+// Follows a primary: the replica's own files are left alone until it is promoted
+void Bank::runReplica(unsigned short primary_port, unsigned short port, bool watch_stdin)
+{
+    raiseOpenFileLimit();
 
-    // Add to in-memory credentials map and BST
-    accountCredentials[account_number] = password;
-    root = insert(root, account_number, name, dob, age, address, phone, deposit_amount_str, acc_type, creation_date_time, creation_date_time);
+    int primary_fd = connectLoopback(primary_port);
+    int listen_fd = primary_fd >= 0 ? openListeningSocket(port, true) : -1;
+    if (primary_fd < 0 || listen_fd < 0)
+    {
+        setConsoleColor(12);
+        cout << "\n\tError: " << (primary_fd < 0 ? "Could not reach the primary on port " + to_string(primary_port)
+                                                 : "Could not listen on port " + to_string(port)) << ".";
+        setConsoleColor(7);
+        if (primary_fd >= 0)
+            close(primary_fd);
+        return;
+    }
 
-    // Save all changes to files
-    saveAllCredentials(); // Save updated account credentials
-    saveAccountsToFile(); // Save updated bank records
+    ServerState state;
+    state.last_save = chrono::steady_clock::now();
+    state.read_only = true;
+    state.primary_connected = true;
+    clearAccounts(); // Replaced by the primary's snapshot
+    accountCredentials.clear();
+    transactionLedger.clear();
+
+    setConsoleColor(10);
+    cout << "\n\tReplica following 127.0.0.1:" << primary_port << ", serving reads on port " << port << ".";
+    cout << (watch_stdin ? "\n\tPress Enter to stop.\n" : "\n");
+    setConsoleColor(7);
+    cout.flush();
+
+    thread receiver(&Bank::replicationReceiver, this, primary_fd, ref(state));
+    serverEventLoop(listen_fd, watch_stdin, state);
+    shutdown(primary_fd, SHUT_RDWR);
+    receiver.join();
+    close(primary_fd);
+    close(listen_fd);
+    if (!state.read_only && state.modified)
+    {
+        saveAccountsToFile();
+        saveAllCredentials();
+    }
+}
+#else
+void Bank::runServer(unsigned short port, unsigned worker_threads, unsigned short replication_port, bool watch_stdin)
+{
+    (void)port;
+    (void)worker_threads;
+    (void)replication_port;
+    (void)watch_stdin;
+    setConsoleColor(12);
+    cout << "\n\tServer mode needs Linux (epoll) and is not available in this build.";
+    setConsoleColor(7);
+}
 
-    setConsoleColor(10); // Green color
-    cout << "\n\tAccount created successfully!";
-    cout << "\n\tAccount Number: " << account_number;
-    cout << "\n\tInitial Balance: Rs " << deposit_amount_str;
+void Bank::runReplica(unsigned short primary_port, unsigned short port, bool watch_stdin)
+{
+    (void)primary_port;
+    (void)port;
+    (void)watch_stdin;
+    setConsoleColor(12);
+    cout << "\n\tReplica mode needs Linux (epoll) and is not available in this build.";
     setConsoleColor(7);
+}
+#endif
 
-    cout << "\n\n\tPress any key to return to Main Menu...";
-    _getch();
-    main(); // Return to main menu
+
+// Apply one replication payload: snapshot lines (A/K/H) or streamed records (L/O)
+void Bank::applyReplicatedPayload(const string &payload)
+{
+    vector<string> fields = splitCsvLine(payload);
+    const string &kind = fields[0];
+    if (kind == "A" && fields.size() >= 11)
+    {
+        // Snapshot records arrive in account order; inserting them one by one would build a list
+        AccountFields record;
+        move(fields.begin() + 1, fields.begin() + 1 + RECORD_FIELDS, record.begin());
+        snapshotAccounts.push_back(makeAccountNode(move(record)));
+    }
+    else if (kind == "O" && fields.size() >= 12)
+    {
+        accountCredentials[fields[1]] = fields[1 + RECORD_FIELDS];
+        AccountFields record;
+        move(fields.begin() + 1, fields.begin() + 1 + RECORD_FIELDS, record.begin());
+        root = insert(root, move(record));
+    }
+    else if (kind == "K" && fields.size() >= 3)
+    {
+        accountCredentials[fields[1]] = fields[2];
+    }
+    else if ((kind == "H" || kind == "L") && fields.size() >= 6)
+    {
+        LedgerEntry entry{static_cast<time_t>(atoll(fields[1].c_str())), fields[2], fields[3], fields[4], atoll(fields[5].c_str())};
+        transactionLedger.push_back(entry);
+        if (kind == "H")
+            return; // History only, the snapshot balances already include it
+
+        // Streamed movement: replay it on the replica's balances
+        string when = formatDateTime(entry.timestamp);
+        auto adjust = [&](const string &acc_no, long long delta) -> AccountNode *
+        {
+            AccountNode *account = findAccount(acc_no);
+            if (account == nullptr)
+                return nullptr;
+            account->balance = formatPaise(parseAmountToPaise(account->balance) + delta);
+            account->last_transaction = when;
+            return account;
+        };
+        bool debit = entry.kind == "Withdrawal" || entry.kind == "Transfer";
+        AccountNode *first = adjust(entry.account, debit ? -entry.amount : entry.amount); // Deposit, Interest credit
+        AccountNode *second = entry.kind == "Transfer" ? adjust(entry.counterparty, entry.amount) : nullptr;
+        commitVersions({first, second});
+    }
 }
 
+// The replica's book is cleared before the snapshot (runReplica), so it is built like a file load
+void Bank::finishReplicatedSnapshot()
+{
+    vector<AccountNode *> accounts;
+    accounts.swap(snapshotAccounts);
+    unsigned long long stamp = versionRegistry.beginCommit();
+    for (AccountNode *account : accounts)
+    {
+        long long paise = parseAmountToPaise(account->balance);
+        account->created_stamp = stamp;
+        account->versions.store(new BalanceVersion(paise, account->last_transaction, stamp), memory_order_relaxed);
+        account->published.publish(paise, account->last_transaction);
+    }
+    sortLoadedAccounts(accounts);
+    root = linkBalanced(accounts.data(), accounts.size());
+    registerLoadedAccounts(accounts);
+    versionRegistry.endCommit(stamp);
+}
 
-void Bank::modifyAccountDetails()
+
+// Failover drill using only local processes: a primary and a replica are forked into their own
+// directories (drill_primary/ with a copy of the book, drill_replica/ empty). The drill writes
+// through the primary, measures how soon each write is visible on the replica, kills the primary
+// with SIGKILL, promotes the replica and checks that it accepts writes from the last state.
+void runReplicationDrill()
 {
     displayAppTitle();
-    cout << "\n\t\tACCOUNT MODIFICATION\n";
-
-    string acc_no;
-    cout << "\n\tEnter the Account Number to modify: ";
+    cout << "\n\t\tREPLICATION FAILOVER DRILL\n";
+#ifdef __linux__
+    unsigned short base_port;
+    string acc_no, password;
+    cout << "\n\tBase Port (uses this and the next two): ";
+    cin >> base_port;
+    cout << "\n\tTest Account Number: ";
     cin >> acc_no;
+    cout << "\n\tTest Account Password: ";
+    password = getSecurePasswordInput();
+    const unsigned short primary_port = base_port, replication_port = base_port + 1, replica_port = base_port + 2;
+    const int WRITES = 200;
 
-    AccountNode *account = search(root, acc_no);
-    if (account == nullptr)
+    static const char *data_files[] = {"Bank_Record.csv", "Account_info.csv", "Employee_info.csv", "Transaction_log.csv"};
+    mkdir("drill_primary", 0755);
+    mkdir("drill_replica", 0755);
+    for (const char *name : data_files)
+    {
+        ifstream source(name, ios::binary);
+        if (source.is_open())
+            ofstream(string("drill_primary/") + name, ios::binary) << source.rdbuf();
+    }
+
+    auto spawn = [](const char *directory, function<void()> body) -> pid_t
+    {
+        cout.flush();
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            if (freopen("/dev/null", "w", stdout) == nullptr || chdir(directory) != 0)
+                _exit(1);
+            accountCredentials.clear();
+            employeeCredentials.clear();
+            loadAllCredentials();
+            loadTransactionLedger();
+            body();
+            _exit(0);
+        }
+        return pid;
+    };
+    pid_t primary = spawn("drill_primary", [&]() { Bank book; book.runServer(primary_port, 1, replication_port, false); });
+    this_thread::sleep_for(chrono::milliseconds(300));
+    pid_t replica = spawn("drill_replica", [&]() { Bank book; book.runReplica(replication_port, replica_port, false); });
+
+    // Minimal blocking line client
+    struct DrillClient
+    {
+        int fd = -1;
+        string buffer;
+        bool open(unsigned short port)
+        {
+            for (int attempt = 0; attempt < 50 && fd < 0; attempt++)
+            {
+                fd = connectLoopback(port);
+                if (fd < 0)
+                    this_thread::sleep_for(chrono::milliseconds(50));
+            }
+            return fd >= 0;
+        }
+        string request(const string &line)
+        {
+            if (fd < 0 || !sendAll(fd, line + "\n"))
+                return "ERR disconnected";
+            size_t end;
+            char chunk[4096];
+            while ((end = buffer.find('\n')) == string::npos)
+            {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0)
+                    return "ERR disconnected";
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            string reply = buffer.substr(0, end);
+            buffer.erase(0, end + 1);
+            return reply;
+        }
+        ~DrillClient()
+        {
+            if (fd >= 0)
+                close(fd);
+        }
+    };
+
+    DrillClient to_primary, to_replica;
+    bool ready = to_primary.open(primary_port) && to_replica.open(replica_port) &&
+                 to_primary.request("LOGIN " + acc_no + " " + password).compare(0, 2, "OK") == 0;
+    for (int attempt = 0; ready && attempt < 50; attempt++) // Wait for the snapshot to arrive
+    {
+        if (to_replica.request("LOGIN " + acc_no + " " + password).compare(0, 2, "OK") == 0)
+            break;
+        if (attempt == 49)
+            ready = false;
+        this_thread::sleep_for(chrono::milliseconds(20));
+    }
+
+    vector<long long> visibility_us;
+    string expected_balance;
+    if (ready)
+    {
+        for (int i = 0; i < WRITES; i++)
+        {
+            string reply = to_primary.request("DEPOSIT 0.01");
+            if (reply.compare(0, 3, "OK ") != 0)
+                break;
+            expected_balance = reply;
+            auto written = chrono::steady_clock::now();
+            while (to_replica.request("BALANCE") != expected_balance &&
+                   chrono::steady_clock::now() - written < chrono::seconds(2))
+            {
+            }
+            visibility_us.push_back(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - written).count());
+        }
+    }
+    string lag_report = ready ? to_replica.request("LAG") : "";
+
+    // Crash the primary and promote the replica
+    kill(primary, SIGKILL);
+    waitpid(primary, nullptr, 0);
+    auto crashed = chrono::steady_clock::now();
+    string promoted = "ERR not attempted";
+    while (ready && chrono::steady_clock::now() - crashed < chrono::seconds(3))
+    {
+        promoted = to_replica.request("PROMOTE");
+        if (promoted.compare(0, 2, "OK") == 0)
+            break;
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    auto failover_ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - crashed).count();
+    string after_failover = ready ? to_replica.request("DEPOSIT 0.01") : "";
+    bool consistent = !expected_balance.empty() &&
+                      parseAmountToPaise(after_failover.size() > 3 ? after_failover.substr(3) : "0") ==
+                          parseAmountToPaise(expected_balance.substr(3)) + 1;
+
+    kill(replica, SIGTERM);
+    waitpid(replica, nullptr, 0);
+    for (const char *directory : {"drill_primary", "drill_replica"})
+    {
+        for (const char *name : data_files)
+        {
+            remove((string(directory) + "/" + name).c_str());
+            remove((string(directory) + "/" + name + ".tmp").c_str());
+        }
+        rmdir(directory);
+    }
+
+    if (!ready)
     {
         setConsoleColor(12);
-        cout << "\n\tAccount Doesn't Exist!";
+        cout << "\n\tThe drill could not start (check the ports and the test account credentials).";
         setConsoleColor(7);
     }
     else
     {
-        setConsoleColor(11); // Cyan
-        cout << "\n\tAccount Found! Current Details:";
-        setConsoleColor(7); // White
-        cout << "\n\tAccount NO.: " << account->account_number;
-        cout << "\n\tName: " << account->name;
-        cout << "\n\tDOB: " << account->dob;
-        cout << "\n\tAge: " << account->age;
-        cout << "\n\tAddress: " << account->address;
-        cout << "\n\tPhone number: " << account->phone;
-        cout << "\n\tType Of Account: " << account->acc_type;
-        cout << "\n\tDate of Account creation: " << account->creation_date;
-        cout << "\n\tAmount deposited: Rs " << account->balance;
-        cout << "\n\tLast Transaction: " << account->last_transaction;
+        sort(visibility_us.begin(), visibility_us.end());
+        auto percentile = [&visibility_us](double p) -> long long
+        {
+            return visibility_us.empty() ? 0 : visibility_us[min(visibility_us.size() - 1, static_cast<size_t>(p * visibility_us.size()))];
+        };
+        setConsoleColor(14);
+        cout << "\n\tReplication";
+        setConsoleColor(7);
+        cout << "\n\tWrites through primary: " << visibility_us.size();
+        cout << "\n\tVisible on replica after p50 " << percentile(0.5) << " us, p99 " << percentile(0.99)
+             << " us, max " << (visibility_us.empty() ? 0 : visibility_us.back()) << " us";
+        cout << "\n\tReplica report: " << lag_report;
+        setConsoleColor(14);
+        cout << "\n\n\tFailover";
+        setConsoleColor(consistent ? 10 : 12);
+        cout << "\n\tPromotion: " << promoted << " (" << failover_ms << " ms after the primary was killed)";
+        cout << "\n\tWrite on promoted replica: " << after_failover;
+        cout << "\n\tBalance continues from the last primary write: " << (consistent ? "yes" : "NO");
+        setConsoleColor(7);
+    }
+#else
+    setConsoleColor(12);
+    cout << "\n\tThe failover drill needs Linux and is not available in this build.";
+    setConsoleColor(7);
+#endif
+    cout << "\n\n\tPress any key to continue...";
+    readKey();
+}
 
-        int choice;
-        string newValue;
-        do
+
+// Loopback load generator for server mode: opens many connections, logs each into the given
+// account (with a session token from a single LOGIN) and keeps one BALANCE request in flight per connection, then reports throughput and
+// latency percentiles. With retries, each request is instead a keyed DEPOSIT of Rs 0.01 sent
+// 1 + retries times (a retry storm); every copy must get the same reply as the first.
+void runLoadTestClient()
+{
+    displayAppTitle();
+    cout << "\n\t\tSERVER LOAD TEST\n";
+#ifdef __linux__
+    unsigned short port;
+    string acc_no, password;
+    size_t connection_count, requests_per_connection, retries;
+    cout << "\n\tServer Port: ";
+    cin >> port;
+    cout << "\n\tTest Account Number: ";
+    cin >> acc_no;
+    cout << "\n\tTest Account Password: ";
+    password = getSecurePasswordInput();
+    cout << "\n\tConcurrent Connections: ";
+    cin >> connection_count;
+    cout << "\n\tRequests per Connection: ";
+    cin >> requests_per_connection;
+    cout << "\n\tRetries per Request (0 for BALANCE only): ";
+    cin >> retries;
+    raiseOpenFileLimit();
+
+    struct ClientState
+    {
+        bool connected = false;
+        bool logged_in = false;
+        size_t remaining = 0;
+        size_t copies_left = 0; // Copies of the current keyed request still to send
+        string request_line;
+        string first_reply;
+        string input;
+        chrono::steady_clock::time_point sent_at;
+    };
+
+    int epoll_fd = epoll_create1(0);
+    unordered_map<int, ClientState> clients;
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    // One real LOGIN pays the password hash; every test connection then opens with its token
+    string login_line = "LOGIN " + acc_no + " " + password + "\n";
+    int token_fd = connectLoopback(port);
+    if (token_fd >= 0 && sendAll(token_fd, login_line))
+    {
+        string reply;
+        char chunk[512];
+        ssize_t n;
+        while (reply.find('\n') == string::npos && (n = recv(token_fd, chunk, sizeof(chunk), 0)) > 0)
+            reply.append(chunk, static_cast<size_t>(n));
+        size_t token_at = reply.find(" TOKEN ");
+        if (reply.compare(0, 2, "OK") == 0 && token_at != string::npos)
+            login_line = "TOKEN " + reply.substr(token_at + 7, reply.find('\n') - token_at - 7) + "\n";
+    }
+    if (token_fd >= 0)
+        close(token_fd);
+
+    auto started = chrono::steady_clock::now();
+    for (size_t c = 0; c < connection_count; c++)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (fd < 0)
+            break;
+        int no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 && errno != EINPROGRESS)
         {
-            cout << "\n\n\tWhat would you like to update?";
-            cout << "\n\t1. Name";
-            cout << "\n\t2. Date of Birth";
-            cout << "\n\t3. Age";
-            cout << "\n\t4. Address";
-            cout << "\n\t5. Phone Number";
-            cout << "\n\t6. Change Account Password"; // New option
-            cout << "\n\t7. Done Updating"; // Changed from 6 to 7
-            cout << "\n\tChoice: ";
-            cin >> choice;
-            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Clear buffer for getline
+            close(fd);
+            continue;
+        }
+        epoll_event add{};
+        add.events = EPOLLOUT | EPOLLIN;
+        add.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &add);
+        clients[fd].remaining = requests_per_connection;
+    }
 
-            switch (choice)
+    const string key_prefix = to_string(static_cast<long long>(time(0))) + "-";
+    size_t keys_issued = 0;
+    vector<long long> latencies_us;
+    latencies_us.reserve(connection_count * requests_per_connection * (retries + 1));
+    size_t failures = 0, divergent_replies = 0;
+    vector<epoll_event> ready(1024);
+
+    auto finish = [&](int fd)
+    {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        clients.erase(fd);
+    };
+
+    while (!clients.empty())
+    {
+        int count = epoll_wait(epoll_fd, ready.data(), static_cast<int>(ready.size()), 5000);
+        if (count == 0)
+            break; // Server stopped answering
+        for (int i = 0; i < count; i++)
+        {
+            int fd = ready[i].data.fd;
+            auto found = clients.find(fd);
+            if (found == clients.end())
+                continue;
+            ClientState &client = found->second;
+
+            if (!client.connected)
             {
-            case 1:
-                cout << "\n\tEnter New Name: ";
-                getline(cin, newValue);
-                account->name = newValue;
-                setConsoleColor(10); cout << "\n\tName updated successfully."; setConsoleColor(7);
-                break;
-            case 2:
-                cout << "\n\tEnter New Date of Birth (DD/MM/YYYY): ";
-                getline(cin, newValue);
-                account->dob = newValue;
-                setConsoleColor(10); cout << "\n\tDate of Birth updated successfully."; setConsoleColor(7);
-                break;
-            case 3:
-                cout << "\n\tEnter New Age: ";
-                cin >> newValue;
-                account->age = newValue;
-                setConsoleColor(10); cout << "\n\tAge updated successfully."; setConsoleColor(7);
-                break;
-            case 4:
-                cout << "\n\tEnter New Address: ";
-                getline(cin, newValue);
-                account->address = newValue;
-                setConsoleColor(10); cout << "\n\tAddress updated successfully."; setConsoleColor(7);
-                break;
-            case 5:
-                cout << "\n\tEnter New Phone Number: ";
-                cin >> newValue;
-                account->phone = newValue;
-                setConsoleColor(10); cout << "\n\tPhone Number updated successfully."; setConsoleColor(7);
-                break;
-            case 6:
-                cout << "\n\tEnter New Password: ";
-                newValue = getSecurePasswordInput();
-                accountCredentials[acc_no] = newValue; // Update in credentials map
-                saveAllCredentials(); // Save updated credentials
-                setConsoleColor(10); cout << "\n\tPassword updated successfully."; setConsoleColor(7);
-                break;
-            case 7:
-                setConsoleColor(10);
-                cout << "\n\tFinishing updates...";
-                setConsoleColor(7);
-                break;
-            default:
-                setConsoleColor(12);
-                cout << "\n\tInvalid Choice! Please try again.";
-                setConsoleColor(7);
-                break;
+                int error = 0;
+                socklen_t length = sizeof(error);
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                if (error != 0)
+                {
+                    failures++;
+                    finish(fd);
+                    continue;
+                }
+                client.connected = true;
+                epoll_event update{};
+                update.events = EPOLLIN;
+                update.data.fd = fd;
+                epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &update);
+                send(fd, login_line.data(), login_line.size(), MSG_NOSIGNAL);
+                continue;
             }
-            if (choice != 7) {
-                cout << "\n\n\tPress any key to continue modifications...";
-                _getch();
-                displayAppTitle();
-                cout << "\n\t\tACCOUNT MODIFICATION\n";
+
+            char buffer[4096];
+            ssize_t n;
+            while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+                client.input.append(buffer, static_cast<size_t>(n));
+            if (n == 0)
+            {
+                failures++;
+                finish(fd);
+                continue;
             }
-        } while (choice != 7);
 
-        saveAccountsToFile(); // Save updated account details to Bank_Record.csv
-        setConsoleColor(10);
-        cout << "\n\tAccount details saved successfully!";
+            size_t line_end;
+            bool done = false;
+            while (!done && (line_end = client.input.find('\n')) != string::npos)
+            {
+                string reply = client.input.substr(0, line_end);
+                client.input.erase(0, line_end + 1);
+                if (reply.compare(0, 2, "OK") != 0)
+                {
+                    failures++;
+                    done = true;
+                    break;
+                }
+                if (client.logged_in)
+                {
+                    latencies_us.push_back(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - client.sent_at).count());
+                    if (client.first_reply.empty())
+                        client.first_reply = reply;
+                    else if (reply != client.first_reply) // Only keyed copies share a request
+                        divergent_replies++;
+                    if (client.copies_left == 0)
+                        client.remaining--;
+                }
+                client.logged_in = true;
+                if (client.remaining == 0)
+                {
+                    done = true;
+                    break;
+                }
+                if (client.copies_left == 0) // Next logical request
+                {
+                    client.copies_left = retries + 1;
+                    client.first_reply.clear();
+                    client.request_line = retries == 0 ? "BALANCE\n" : "DEPOSIT 0.01 " + key_prefix + to_string(keys_issued++) + "\n";
+                }
+                client.copies_left--;
+                client.sent_at = chrono::steady_clock::now();
+                send(fd, client.request_line.data(), client.request_line.size(), MSG_NOSIGNAL);
+            }
+            if (done)
+                finish(fd);
+        }
+    }
+    for (auto &pair : clients)
+        close(pair.first);
+    close(epoll_fd);
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    sort(latencies_us.begin(), latencies_us.end());
+    auto percentile = [&latencies_us](double p) -> long long
+    {
+        if (latencies_us.empty())
+            return 0;
+        return latencies_us[min(latencies_us.size() - 1, static_cast<size_t>(p * latencies_us.size()))];
+    };
+
+    setConsoleColor(14);
+    cout << "\n\tLoad Test Results";
+    setConsoleColor(7);
+    cout << "\n\tCompleted Requests: " << latencies_us.size() << " (" << failures << " failed connection(s))";
+    if (retries > 0)
+        cout << "\n\tIdempotency Keys: " << keys_issued << ", retries with a different reply: " << divergent_replies;
+    cout << "\n\tElapsed: " << fixed << setprecision(3) << seconds << " s";
+    cout << "\n\tThroughput: " << setprecision(0) << (seconds > 0 ? latencies_us.size() / seconds : 0) << " requests/s";
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+    cout << "\n\tLatency p50: " << percentile(0.50) << " us, p99: " << percentile(0.99)
+         << " us, p99.9: " << percentile(0.999) << " us, max: " << (latencies_us.empty() ? 0 : latencies_us.back()) << " us";
+#else
+    setConsoleColor(12);
+    cout << "\n\tThe load test needs Linux (epoll) and is not available in this build.";
+    setConsoleColor(7);
+#endif
+    cout << "\n\n\tPress any key to continue...";
+    readKey();
+}
+
+
+// Server tools (reached from the main menu)
+void showServerMenu()
+{
+    displayAppTitle();
+    setConsoleColor(14);
+    cout << "\n\t\tSERVER MODE\n";
+    setConsoleColor(7);
+    cout << "\n\t1. Start Server on Local Port";
+    cout << "\n\t2. Run Loopback Load Test";
+    cout << "\n\t3. Start Read Replica";
+    cout << "\n\t4. Run Replication Failover Drill";
+    cout << "\n\t5. Return to Main Menu";
+    cout << "\n\n\tEnter your choice: ";
+
+    int choice;
+    while (!(cin >> choice) || choice < 1 || choice > 5) {
+        setConsoleColor(12);
+        cout << "\n\tInvalid choice. Please enter a number between 1 and 5: ";
         setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    if (choice == 1)
+    {
+        unsigned short port, replication_port;
+        unsigned worker_threads;
+        cout << "\n\tPort (e.g. 5050): ";
+        cin >> port;
+        cout << "\n\tReplication Port (0 for none): ";
+        cin >> replication_port;
+        cout << "\n\tServer Threads (e.g. 2): ";
+        while (!(cin >> worker_threads) || worker_threads == 0 || worker_threads > 64) {
+            setConsoleColor(12);
+            cout << "\n\tInvalid value. Please enter a number between 1 and 64: ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        Bank server_bank; // One shared account book for all connections
+        server_bank.runServer(port, worker_threads, replication_port);
+        cout << "\n\n\tPress any key to continue...";
+        readKey();
+    }
+    else if (choice == 2)
+    {
+        runLoadTestClient();
+    }
+    else if (choice == 3)
+    {
+        unsigned short primary_port, port;
+        cout << "\n\tPrimary Replication Port: ";
+        cin >> primary_port;
+        cout << "\n\tPort to Serve Reads On: ";
+        cin >> port;
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        Bank replica_bank;
+        replica_bank.runReplica(primary_port, port);
+        cout << "\n\n\tPress any key to continue...";
+        readKey();
+    }
+    else if (choice == 4)
+    {
+        runReplicationDrill();
     }
+    main();
+}
 
-    cout << "\n\n\tPress any key to return to menu...";
-    _getch();
-    showCustomerMenu(); // Assume customer is logged in, or route to main menu if called by employee
+
+// --- Sharded Account Book ---
+// The book is split into N shards by a stable hash of the account number. Each shard has its own
+// record file, redo journal and mutex, so transfers inside different shards run in parallel.
+//
+// Shard journal lines are "<lsn>,<entry>" with entries:
+//   T,txid,from,to,amount   same-shard transfer        P,txid,acc,delta   prepared cross-shard leg
+//   C,txid                  prepared leg committed     A,txid             prepared leg aborted
+//   H,txid,from,to,amount   transfer into a hot account, logged in the sender's shard only
+// A prepared debit is applied at once (funds are held); a prepared credit only on commit.
+// The coordinator log holds the commit decisions ("C,txid"); a prepared transaction without a
+// decision is aborted on recovery (presumed abort).
+//
+// Hot accounts (Hot_accounts.csv) are recipients so busy that their shard lock would serialize
+// every transfer into them. Credits to a hot account take only the sender's shard lock and add to
+// one of several per-thread sub-balances; the sub-balances are folded into the record (under the
+// hot account's shard lock) before it is debited, read or checkpointed, so totals stay exact.
+
+// Append one line and, when 'sync' is set, force it to disk before returning
+static bool appendJournalLine(FILE *file, const string &line, bool sync)
+{
+    if (file == nullptr || fputs(line.c_str(), file) < 0 || fputc('\n', file) == EOF || fflush(file) != 0)
+        return false;
+    if (!sync)
+        return true;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
 }
 
+// Parse a whole journal field as a number; false for empty, partial or out-of-range text, as in
+// a line torn by a crash
+static bool parseJournalNumber(const string &field, unsigned long long &value)
+{
+    if (field.empty() || !isdigit(static_cast<unsigned char>(field[0])))
+        return false;
+    char *end = nullptr;
+    errno = 0;
+    value = strtoull(field.c_str(), &end, 10);
+    return errno == 0 && end == field.c_str() + field.size();
+}
 
-void Bank::searchAccountRecord()
+static bool parseJournalNumber(const string &field, long long &value)
 {
-    displayAppTitle();
-    cout << "\n\t\tACCOUNT SEARCH\n";
+    if (field.empty())
+        return false;
+    char *end = nullptr;
+    errno = 0;
+    value = strtoll(field.c_str(), &end, 10);
+    return errno == 0 && end == field.c_str() + field.size();
+}
 
-    int search_type_choice;
-    cout << "\n\tSearch by:\n\t1. Account Number\n\t2. Name\n\tChoice: ";
-    while (!(cin >> search_type_choice) || (search_type_choice < 1 || search_type_choice > 2)) {
-        setConsoleColor(12);
-        cout << "\n\tInvalid choice. Please enter 1 or 2: ";
-        setConsoleColor(7);
-        cin.clear();
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+// Stable shard number for an account (FNV-1a, unlike std::hash it never changes between builds)
+static size_t shardOfAccount(const string &acc_no, size_t shard_count)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for (unsigned char c : acc_no)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
     }
-    cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Clear buffer
+    return static_cast<size_t>(hash % shard_count);
+}
 
-    if (search_type_choice == 1)
+class ShardedBank
+{
+public:
+    ShardedBank(size_t shard_count, const string &file_prefix, bool sync_journals, const vector<string> &hot_accounts = {})
+        : prefix(file_prefix), sync(sync_journals)
     {
-        string acc_no;
-        cout << "\n\tEnter Account Number to search: ";
-        cin >> acc_no;
+        for (size_t i = 0; i < shard_count; i++)
+        {
+            shards.emplace_back(new Shard());
+            shards[i]->book.reset(new Bank(recordPath(i)));
+        }
+        recover();
+        for (size_t i = 0; i < shard_count; i++)
+            shards[i]->journal = fopen(journalPath(i).c_str(), "a");
+        coordinator = fopen(coordinatorPath().c_str(), "a");
 
-        AccountNode *account = search(root, acc_no);
-        if (account == nullptr)
+        // Fixed for the book's lifetime, so transfers look hot accounts up without a lock
+        for (const string &acc_no : hot_accounts)
         {
-            setConsoleColor(12);
-            cout << "\n\tAccount Doesn't Exist!";
-            setConsoleColor(7);
+            size_t index = shardOf(acc_no);
+            Bank::AccountNode *account = shards[index]->book->findAccount(acc_no);
+            if (account != nullptr && !hot.count(acc_no))
+                hot.emplace(acc_no, unique_ptr<HotAccount>(new HotAccount{account, index, {}}));
         }
-        else
+    }
+
+    ~ShardedBank()
+    {
+        checkpoint();
+        for (auto &shard : shards)
         {
-            setConsoleColor(11);
-            cout << "\n\tAccount Details Found:";
-            setConsoleColor(7);
-            cout << "\n\tAccount NO.: " << account->account_number;
-            cout << "\n\tName: " << account->name;
-            cout << "\n\tDOB: " << account->dob;
-            cout << "\n\tAge: " << account->age;
-            cout << "\n\tAddress: " << account->address;
-            cout << "\n\tPhone number: " << account->phone;
-            cout << "\n\tType Of Account: " << account->acc_type;
-            cout << "\n\tDate of Account creation: " << account->creation_date;
-            cout << "\n\tBalance: Rs " << account->balance;
-            cout << "\n\tLast Transaction: " << account->last_transaction;
+            if (shard->journal)
+                fclose(shard->journal);
         }
+        if (coordinator)
+            fclose(coordinator);
     }
-    else if (search_type_choice == 2)
+
+    size_t shardCount() const { return shards.size(); }
+    size_t shardOf(const string &acc_no) const { return shardOfAccount(acc_no, shards.size()); }
+    size_t hotCount() const { return hot.size(); }
+
+    // Balances of hot accounts are consolidated first, so the answer is exact
+    bool balanceOf(const string &acc_no, long long &balance)
     {
-        string name_search;
-        cout << "\n\tEnter Name (or part of name) to search: ";
-        getline(cin, name_search);
+        Shard &shard = *shards[shardOf(acc_no)];
+        lock_guard<mutex> lock(shard.lock);
+        Bank::AccountNode *account = shard.book->findAccount(acc_no);
+        if (account == nullptr)
+            return false;
+        consolidate(acc_no);
+        balance = parseAmountToPaise(account->balance);
+        return true;
+    }
 
-        bool found = false;
-        // Lambda function for in-order traversal to search by name
-        function<void(AccountNode *)> searchByNameTraversal = [&](AccountNode *node)
+    // Same-shard transfers are one journal record under one lock. Cross-shard transfers run the
+    // two-phase protocol: prepare both legs, log the decision, then commit both legs. Transfers
+    // into a hot account lock the sender's shard only.
+    TxnStatus transfer(const string &from_acc_no, const string &to_acc_no, long long amount)
+    {
+        if (from_acc_no == to_acc_no)
+            return TxnStatus::SameAccount;
+        if (amount <= 0)
+            return TxnStatus::InvalidAmount;
+
+        size_t from_index = shardOf(from_acc_no), to_index = shardOf(to_acc_no);
+        Shard &from_shard = *shards[from_index];
+        Shard &to_shard = *shards[to_index];
+
+        auto hot_to = hot.find(to_acc_no);
+        if (hot_to != hot.end())
         {
-            if (node == nullptr)
-                return;
+            lock_guard<mutex> lock(from_shard.lock);
+            Bank::AccountNode *from_account = from_shard.book->findAccount(from_acc_no);
+            consolidate(from_acc_no); // A hot sender is debited from its consolidated balance
+            TxnStatus status = validate(from_account, hot_to->second->account, amount);
+            if (status != TxnStatus::Ok)
+                return status;
+            unsigned long long txid = next_txid++;
+            if (!journal(from_shard, "H," + to_string(txid) + "," + from_acc_no + "," + to_acc_no + "," + to_string(amount), sync))
+                return TxnStatus::StorageError;
+            applyDelta(from_account, -amount, true);
+            from_shard.book->commitVersions({from_account});
+            // Added while the sender's shard is still locked, so a checkpoint (all locks) sees it
+            hot_to->second->stripes[hotStripe()].credits.fetch_add(amount, memory_order_relaxed);
+            return TxnStatus::Ok;
+        }
 
-            searchByNameTraversal(node->left);
+        if (from_index == to_index)
+        {
+            lock_guard<mutex> lock(from_shard.lock);
+            Bank::AccountNode *from_account = from_shard.book->findAccount(from_acc_no);
+            Bank::AccountNode *to_account = from_shard.book->findAccount(to_acc_no);
+            consolidate(from_acc_no);
+            TxnStatus status = validate(from_account, to_account, amount);
+            if (status != TxnStatus::Ok)
+                return status;
+            unsigned long long txid = next_txid++;
+            if (!journal(from_shard, "T," + to_string(txid) + "," + from_acc_no + "," + to_acc_no + "," + to_string(amount), sync))
+                return TxnStatus::StorageError;
+            applyDelta(from_account, -amount, true);
+            applyDelta(to_account, amount, true);
+            from_shard.book->commitVersions({from_account, to_account});
+            return TxnStatus::Ok;
+        }
 
-            // Case-insensitive search for name
-            string node_name_lower = node->name;
-            string search_name_lower = name_search;
-            transform(node_name_lower.begin(), node_name_lower.end(), node_name_lower.begin(), ::tolower);
-            transform(search_name_lower.begin(), search_name_lower.end(), search_name_lower.begin(), ::tolower);
+        scoped_lock locks(from_shard.lock, to_shard.lock); // Deadlock-free acquisition of both shards
+        Bank::AccountNode *from_account = from_shard.book->findAccount(from_acc_no);
+        Bank::AccountNode *to_account = to_shard.book->findAccount(to_acc_no);
+        consolidate(from_acc_no);
+        TxnStatus status = validate(from_account, to_account, amount);
+        if (status != TxnStatus::Ok)
+            return status;
+
+        // Phase 1: prepare both legs
+        unsigned long long txid = next_txid++;
+        string id = to_string(txid);
+        if (!journal(from_shard, "P," + id + "," + from_acc_no + "," + to_string(-amount), sync))
+            return TxnStatus::StorageError;
+        applyDelta(from_account, -amount, true); // Hold the funds
+        from_shard.book->commitVersions({from_account});
+        bool prepared = journal(to_shard, "P," + id + "," + to_acc_no + "," + to_string(amount), sync);
+
+        // Decision: the transfer is committed once the coordinator log says so
+        bool committed = false;
+        if (prepared)
+        {
+            lock_guard<mutex> lock(coordinator_lock);
+            committed = appendJournalLine(coordinator, "C," + id, sync);
+        }
+        if (!committed)
+        {
+            journal(from_shard, "A," + id, false);
+            if (prepared)
+                journal(to_shard, "A," + id, false);
+            applyDelta(from_account, amount, false); // Release the held funds
+            from_shard.book->commitVersions({from_account});
+            return TxnStatus::StorageError;
+        }
 
-            if (node_name_lower.find(search_name_lower) != string::npos)
-            {
-                if (!found)
-                {
-                    setConsoleColor(11);
-                    cout << "\n\tAccounts Found (matching '" << name_search << "'):";
-                    setConsoleColor(7);
-                    found = true;
-                }
+        // Phase 2: commit both legs (recovery redoes these from the coordinator log if lost)
+        journal(from_shard, "C," + id, false);
+        journal(to_shard, "C," + id, false);
+        applyDelta(to_account, amount, true);
+        to_shard.book->commitVersions({to_account});
+        return TxnStatus::Ok;
+    }
 
-                cout << "\n\n\tAccount NO.: " << node->account_number;
-                cout << "\n\tName: " << node->name;
-                cout << "\n\tType Of Account: " << node->acc_type;
-                cout << "\n\tBalance: Rs " << node->balance;
-                cout << "\n\tLast Transaction: " << node->last_transaction;
-                cout << "\n\t---------------------------";
+    // Save every shard with the journal position it covers, then start empty journals.
+    // Hot credits are logged in the senders' journals but folded into the hot accounts' shard
+    // files, so each header also lists every shard's position at the fold:
+    // "#lsn,<own lsn>,<lsn of shard 0>;<lsn of shard 1>;...". Journals are only emptied once every
+    // file has been swapped in; until then recovery replays each H credit into the recipient's
+    // file exactly when that file predates it, whichever renames a crash interrupted.
+    void checkpoint()
+    {
+        for (auto &shard_ptr : shards)
+            shard_ptr->lock.lock();
+        lock_guard<mutex> coordinator_guard(coordinator_lock);
+
+        for (auto &entry : hot)
+            consolidate(entry.first);
+        string positions;
+        for (size_t i = 0; i < shards.size(); i++)
+            positions += (i ? ";" : "") + to_string(shards[i]->lsn);
+        bool all_saved = true;
+        for (size_t i = 0; i < shards.size() && all_saved; i++)
+            all_saved = shards[i]->book->writeAccountsFile(recordPath(i) + ".tmp", "#lsn," + to_string(shards[i]->lsn) + "," + positions);
+        for (size_t i = 0; i < shards.size() && all_saved; i++)
+            all_saved = replaceFile(recordPath(i) + ".tmp", recordPath(i));
+        if (all_saved) // No shard file still needs old journal records or decisions
+        {
+            for (size_t i = 0; i < shards.size(); i++)
+            {
+                Shard &shard = *shards[i];
+                if (shard.journal)
+                    fclose(shard.journal);
+                shard.journal = fopen(journalPath(i).c_str(), "w");
             }
+            if (coordinator)
+                fclose(coordinator);
+            coordinator = fopen(coordinatorPath().c_str(), "w");
+        }
 
-            searchByNameTraversal(node->right);
-        };
+        for (auto &shard_ptr : shards)
+            shard_ptr->lock.unlock();
+    }
 
-        searchByNameTraversal(root);
+    // Distribute the records of a single-file book into shard files. Returns accounts written.
+    static size_t splitBook(const string &source_file, size_t shard_count, const string &file_prefix)
+    {
+        ifstream source(source_file);
+        if (!source.is_open())
+            return 0;
+
+        vector<ofstream> outputs;
+        string positions = "0";
+        for (size_t i = 1; i < shard_count; i++)
+            positions += ";0";
+        for (size_t i = 0; i < shard_count; i++)
+        {
+            outputs.emplace_back(file_prefix + "_" + to_string(i) + "_Record.csv");
+            outputs.back() << "#lsn,0," << positions << "\n"; // Nothing journaled or folded yet
+            remove((file_prefix + "_" + to_string(i) + ".journal").c_str());
+        }
+        remove((file_prefix + "_coordinator.log").c_str());
 
-        if (!found)
+        size_t written = 0;
+        string line;
+        while (getline(source, line))
         {
-            setConsoleColor(12);
-            cout << "\n\tNo accounts with that name (or matching part) were found!";
-            setConsoleColor(7);
+            size_t comma = line.find(',');
+            if (comma == string::npos || count(line.begin(), line.end(), ',') < 9)
+                continue;
+            outputs[shardOfAccount(line.substr(0, comma), shard_count)] << line << "\n";
+            written++;
         }
+        return written;
     }
 
-    cout << "\n\n\tPress any key to return to menu...";
-    _getch();
-    // Decide which menu to return to based on context (e.g., employee or customer)
-    // For simplicity, let's assume this is called from customer menu, or main menu for employee
-    // You might want to pass a flag to this function to decide where to return
-    if (cin.peek() == EOF) { // Simple check if EOF implies called from employee context
-         showEmployeeMenu();
-    } else {
-        showCustomerMenu();
-    }
-}
+private:
+    struct Shard
+    {
+        unique_ptr<Bank> book;
+        mutex lock;
+        FILE *journal = nullptr;
+        unsigned long long lsn = 0; // Last journal sequence number written
+    };
 
+    // Credits not yet folded into a hot account's record, one cache line per stripe so threads
+    // crediting the same account don't share a line
+    static constexpr size_t HOT_STRIPES = 16;
+    struct alignas(64) HotStripe
+    {
+        atomic<long long> credits{0};
+    };
+    struct HotAccount
+    {
+        Bank::AccountNode *account;
+        size_t shard;
+        array<HotStripe, HOT_STRIPES> stripes;
+    };
 
-void Bank::handleDepositWithdrawal()
-{
-    displayAppTitle();
-    cout << "\n\t\tTRANSACTIONS\n";
+    vector<unique_ptr<Shard>> shards;
+    unordered_map<string, unique_ptr<HotAccount>> hot;
+    string prefix;
+    bool sync;
+    mutex coordinator_lock;
+    FILE *coordinator = nullptr;
+    atomic<unsigned long long> next_txid{1};
 
-    string acc_no;
-    cout << "\n\tEnter Account Number: ";
-    cin >> acc_no;
+    string recordPath(size_t i) const { return prefix + "_" + to_string(i) + "_Record.csv"; }
+    string journalPath(size_t i) const { return prefix + "_" + to_string(i) + ".journal"; }
+    string coordinatorPath() const { return prefix + "_coordinator.log"; }
 
-    AccountNode *account = search(root, acc_no);
-    if (account == nullptr)
+    static TxnStatus validate(Bank::AccountNode *from_account, Bank::AccountNode *to_account, long long amount)
     {
-        setConsoleColor(12);
-        cout << "\n\tAccount Doesn't Exist!";
-        setConsoleColor(7);
+        if (from_account == nullptr)
+            return TxnStatus::NoSuchAccount;
+        if (to_account == nullptr)
+            return TxnStatus::NoSuchRecipient;
+        if (amount > parseAmountToPaise(from_account->balance))
+            return TxnStatus::InsufficientFunds;
+        return TxnStatus::Ok;
     }
-    else
+
+    static void applyDelta(Bank::AccountNode *account, long long delta, bool touch)
     {
-        setConsoleColor(11);
-        cout << "\n\tAccount Details:";
-        setConsoleColor(7);
-        cout << "\n\tAccount NO.: " << account->account_number;
-        cout << "\n\tName: " << account->name;
-        cout << "\n\tCurrent Balance: Rs " << account->balance;
+        if (account == nullptr)
+            return;
+        account->balance = formatPaise(parseAmountToPaise(account->balance) + delta);
+        if (touch)
+            account->last_transaction = getCurrentDateTime();
+    }
 
-        int transaction_type_choice;
-        cout << "\n\n\t1. Deposit\n\t2. Withdraw\n\tChoice: ";
-        while (!(cin >> transaction_type_choice) || (transaction_type_choice < 1 || transaction_type_choice > 2)) {
-            setConsoleColor(12);
-            cout << "\n\tInvalid choice. Please enter 1 or 2: ";
-            setConsoleColor(7);
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        }
+    // Each thread credits its own stripe (threads are numbered on first use)
+    static size_t hotStripe()
+    {
+        static atomic<size_t> next_thread{0};
+        thread_local size_t stripe = next_thread.fetch_add(1, memory_order_relaxed) % HOT_STRIPES;
+        return stripe;
+    }
 
-        float amount;
-        cout << "\n\tEnter Amount: Rs ";
-        while (!(cin >> amount) || amount <= 0) { // Validate positive amount
-            setConsoleColor(12);
-            cout << "\n\tInvalid amount. Please enter a positive number: Rs ";
-            setConsoleColor(7);
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        }
+    // Fold a hot account's pending credits into its record (its shard lock held; no-op otherwise)
+    void consolidate(const string &acc_no)
+    {
+        auto it = hot.find(acc_no);
+        if (it == hot.end())
+            return;
+        HotAccount &account = *it->second;
+        long long pending = 0;
+        for (HotStripe &stripe : account.stripes)
+            pending += stripe.credits.exchange(0, memory_order_relaxed);
+        if (pending == 0)
+            return;
+        applyDelta(account.account, pending, true);
+        shards[account.shard]->book->commitVersions({account.account});
+    }
 
-        float current_balance = stof(account->balance);
-        string transaction_description;
+    // Append an entry to a shard journal (shard lock held)
+    bool journal(Shard &shard, const string &entry, bool sync_now)
+    {
+        return appendJournalLine(shard.journal, to_string(++shard.lsn) + "," + entry, sync_now);
+    }
 
-        if (transaction_type_choice == 1) // Deposit
+    // Replay journals written after each shard's checkpoint and resolve in-doubt transfers
+    void recover()
+    {
+        vector<pair<string, long long>> hot_credits; // Credit legs of H entries, applied in the recipients' shards
+        vector<bool> replayed(shards.size(), false);
+        set<unsigned long long> decided;
+        unsigned long long max_txid = 0;
         {
-            current_balance += amount;
-            transaction_description = "Deposit: +Rs " + to_string(amount) + " to " + acc_no;
-            setConsoleColor(10);
-            cout << "\n\tDeposit Successful!";
-            setConsoleColor(7);
+            ifstream decisions(coordinatorPath());
+            string line;
+            while (getline(decisions, line))
+            {
+                vector<string> fields = splitCsvLine(line);
+                unsigned long long txid;
+                if (fields.size() == 2 && fields[0] == "C" && parseJournalNumber(fields[1], txid))
+                    decided.insert(txid);
+            }
+        }
+        if (!decided.empty())
+            max_txid = *decided.rbegin();
+
+        // Checkpoint headers: each file's own journal position, and the position of every sender
+        // whose hot credits it already holds (headers from before the list existed come from
+        // checkpoints that swapped every file together, so the senders' own positions apply)
+        size_t shard_count = shards.size();
+        vector<unsigned long long> checkpoint_lsns(shard_count, 0);
+        vector<vector<unsigned long long>> folded(shard_count);
+        for (size_t i = 0; i < shard_count; i++)
+        {
+            ifstream records(recordPath(i));
+            string header;
+            if (!getline(records, header) || header.compare(0, 5, "#lsn,") != 0)
+                continue;
+            vector<string> fields = splitCsvLine(header);
+            if (fields.size() < 2 || !parseJournalNumber(fields[1], checkpoint_lsns[i]))
+                checkpoint_lsns[i] = 0;
+            if (fields.size() < 3)
+                continue;
+            stringstream positions(fields[2]);
+            string position;
+            unsigned long long value;
+            while (getline(positions, position, ';') && parseJournalNumber(position, value))
+                folded[i].push_back(value);
+            if (folded[i].size() != shard_count)
+                folded[i].clear();
         }
-        else // Withdraw
+        for (size_t i = 0; i < shard_count; i++)
         {
-            if (amount > current_balance)
+            if (folded[i].empty())
+                folded[i] = checkpoint_lsns;
+        }
+
+        for (size_t i = 0; i < shard_count; i++)
+        {
+            Shard &shard = *shards[i];
+            Bank &book = *shard.book;
+            unsigned long long checkpoint_lsn = checkpoint_lsns[i];
+            shard.lsn = checkpoint_lsn;
+
+            map<unsigned long long, pair<string, long long>> in_doubt; // txid -> prepared leg
+            ifstream journal_file(journalPath(i));
+            string line;
+            while (getline(journal_file, line))
             {
-                setConsoleColor(12);
-                cout << "\n\tInsufficient Balance!";
-                setConsoleColor(7);
-                amount = 0; // Prevent balance change
+                vector<string> fields = splitCsvLine(line);
+                unsigned long long lsn, txid;
+                if (fields.size() < 3 || !parseJournalNumber(fields[0], lsn) || !parseJournalNumber(fields[2], txid))
+                    continue; // Torn final line from a crash
+                max_txid = max(max_txid, txid);
+
+                const string &kind = fields[1];
+                long long amount;
+                bool hot_credit = kind == "H" && fields.size() == 6 && parseJournalNumber(fields[5], amount);
+                // The credit leg is judged by the recipient's file, which may be older than this one
+                if (hot_credit && lsn > folded[shardOf(fields[4])][i])
+                    hot_credits.emplace_back(fields[4], amount);
+                if (lsn <= checkpoint_lsn)
+                    continue;
+                shard.lsn = max(shard.lsn, lsn);
+
+                if (hot_credit)
+                {
+                    applyDelta(book.findAccount(fields[3]), -amount, false);
+                }
+                else if (kind == "T" && fields.size() == 6 && parseJournalNumber(fields[5], amount))
+                {
+                    applyDelta(book.findAccount(fields[3]), -amount, false);
+                    applyDelta(book.findAccount(fields[4]), amount, false);
+                }
+                else if (kind == "P" && fields.size() == 5 && parseJournalNumber(fields[4], amount))
+                {
+                    in_doubt[txid] = make_pair(fields[3], amount);
+                    if (amount < 0)
+                        applyDelta(book.findAccount(fields[3]), amount, false);
+                }
+                else if ((kind == "C" || kind == "A") && in_doubt.count(txid))
+                {
+                    const pair<string, long long> &leg = in_doubt[txid];
+                    if (kind == "C" && leg.second > 0)
+                        applyDelta(book.findAccount(leg.first), leg.second, false);
+                    if (kind == "A" && leg.second < 0)
+                        applyDelta(book.findAccount(leg.first), -leg.second, false);
+                    in_doubt.erase(txid);
+                }
             }
-            else
+            journal_file.close();
+
+            // Legs still in doubt: commit if the coordinator decided, otherwise abort
+            if (!in_doubt.empty())
             {
-                current_balance -= amount;
-                transaction_description = "Withdrawal: -Rs " + to_string(amount) + " from " + acc_no;
-                setConsoleColor(10);
-                cout << "\n\tWithdrawal Successful!";
-                setConsoleColor(7);
+                shard.journal = fopen(journalPath(i).c_str(), "a");
+                for (const auto &pair : in_doubt)
+                {
+                    bool commit = decided.count(pair.first) > 0;
+                    journal(shard, (commit ? "C," : "A,") + to_string(pair.first), sync);
+                    if (commit && pair.second.second > 0)
+                        applyDelta(book.findAccount(pair.second.first), pair.second.second, false);
+                    if (!commit && pair.second.second < 0)
+                        applyDelta(book.findAccount(pair.second.first), -pair.second.second, false);
+                }
+                fclose(shard.journal);
+                shard.journal = nullptr;
             }
+            replayed[i] = shard.lsn > checkpoint_lsn;
         }
 
-        if (amount > 0) { // Only update if a valid transaction occurred
-            account->balance = to_string(current_balance);
-            transactionHistory.push_back(transaction_description);
-            recentTransactions.push(transaction_description);
-
-            // Update last transaction date
-            account->last_transaction = getCurrentDateTime();
-            saveAccountsToFile(); // Save updated balance and last transaction date
-            cout << "\n\tNew Balance: Rs " << account->balance;
+        for (const auto &credit : hot_credits)
+        {
+            size_t index = shardOf(credit.first);
+            applyDelta(shards[index]->book->findAccount(credit.first), credit.second, false);
+            replayed[index] = true;
         }
+        for (size_t i = 0; i < shards.size(); i++)
+        {
+            if (!replayed[i])
+                continue;
+            // Replay changed balances behind the versions' back; republish them all
+            Bank &book = *shards[i]->book;
+            vector<Bank::AccountNode *> accounts;
+            book.collectAllAccounts(accounts);
+            book.commitVersions(accounts.data(), accounts.size());
+        }
+        next_txid = max_txid + 1;
     }
+};
 
-    cout << "\n\n\tPress any key to return to menu...";
-    _getch();
-    showCustomerMenu();
+// Number of shards the book was split into (Shard_config.csv), 0 if it was never split
+static size_t loadShardCount()
+{
+    ifstream file("Shard_config.csv");
+    size_t shard_count = 0;
+    file >> shard_count;
+    return shard_count;
 }
 
-
-void Bank::displayAllAccounts()
+// Accounts designated hot (Hot_accounts.csv, one account number per line)
+static vector<string> loadHotAccounts()
 {
-    displayAppTitle();
-    cout << "\n\t\tALL ACCOUNT HOLDERS\n";
-
-    if (root == nullptr) {
-        setConsoleColor(12);
-        cout << "\n\tNo accounts to display.";
-        setConsoleColor(7);
-    } else {
-        setConsoleColor(14); // Yellow
-        cout << left
-             << "\n\t" << setw(20) << "Account No."
-             << setw(30) << "Name"
-             << setw(20) << "Type"
-             << setw(15) << "Balance" << "\n";
-        cout << "\t" << string(85, '-') << "\n";
-        setConsoleColor(7); // White
-
-        inorder(root); // Perform in-order traversal to display accounts
+    ifstream file("Hot_accounts.csv");
+    vector<string> accounts;
+    string line;
+    while (getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (!line.empty())
+            accounts.push_back(line);
     }
-
-
-    cout << "\n\n\tPress any key to return to menu...";
-    _getch();
-    showEmployeeMenu(); // Return to employee menu
+    return accounts;
 }
 
-
-void Bank::performFundTransfer()
+static bool saveHotAccounts(const vector<string> &accounts)
 {
-    displayAppTitle();
-    cout << "\n\t\tFUND TRANSFER\n";
+    ofstream file("Hot_accounts.csv");
+    for (const string &acc_no : accounts)
+        file << acc_no << "\n";
+    file.close();
+    return !file.fail();
+}
 
-    string from_acc_no, to_acc_no;
-    float amount;
+// Measures transfers into one payroll-style recipient from 1, 2, 4 and 8 worker threads on an
+// 8-shard book, with the recipient as a plain account and as a hot account, and checks that the
+// recipient received exactly what the senders lost.
+void runHotAccountBenchmark()
+{
+    const size_t ACCOUNTS = 20000;
+    const size_t TRANSFERS = 80000;
+    const size_t SHARDS = 8;
+    const string prefix = "Bench_Hot";
+    const string recipient = "10000000";
 
-    cout << "\n\tEnter Your Account Number (Sender): ";
-    cin >> from_acc_no;
+    {
+        ofstream source("Bench_Source.csv");
+        string creation_date = getCurrentDateTime();
+        vector<size_t> order(ACCOUNTS);
+        iota(order.begin(), order.end(), 0);
+        shuffle(order.begin(), order.end(), mt19937(42));
+        for (size_t i : order)
+        {
+            source << 10000000 + i << ",Bench,01/01/2000,25,Bench Street,0000000000,1000000.00,Saving,"
+                   << creation_date << "," << creation_date << "\n";
+        }
+    }
 
-    AccountNode *from_account = search(root, from_acc_no);
-    if (from_account == nullptr)
+    setConsoleColor(14);
+    cout << "\n\t" << left << setw(10) << "Threads" << setw(18) << "Plain (txn/s)" << setw(18) << "Hot (txn/s)" << "Totals";
+    setConsoleColor(7);
+    for (size_t threads = 1; threads <= 8; threads *= 2)
     {
-        setConsoleColor(12);
-        cout << "\n\tSender Account Doesn't Exist!";
+        long long rates[2];
+        bool exact = true;
+        for (int mode = 0; mode < 2; mode++)
+        {
+            ShardedBank::splitBook("Bench_Source.csv", SHARDS, prefix);
+            {
+                ShardedBank book(SHARDS, prefix, false, mode == 1 ? vector<string>{recipient} : vector<string>{});
+                long long before = 0;
+                book.balanceOf(recipient, before);
+                vector<long long> sent(threads, 0);
+                auto started = chrono::steady_clock::now();
+                vector<thread> workers;
+                for (size_t w = 0; w < threads; w++)
+                {
+                    workers.emplace_back([&, w]()
+                    {
+                        mt19937 random(static_cast<unsigned>(w + 1));
+                        for (size_t t = 0; t < TRANSFERS / threads; t++)
+                        {
+                            long long amount = 100 + random() % 1000;
+                            string from = to_string(10000001 + random() % (ACCOUNTS - 1));
+                            if (book.transfer(from, recipient, amount) == TxnStatus::Ok)
+                                sent[w] += amount;
+                        }
+                    });
+                }
+                for (thread &worker : workers)
+                    worker.join();
+                double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+                rates[mode] = static_cast<long long>(TRANSFERS / seconds);
+
+                long long after = 0;
+                book.balanceOf(recipient, after);
+                exact = exact && after - before == accumulate(sent.begin(), sent.end(), 0LL);
+            }
+            for (size_t i = 0; i < SHARDS; i++)
+            {
+                remove((prefix + "_" + to_string(i) + "_Record.csv").c_str());
+                remove((prefix + "_" + to_string(i) + ".journal").c_str());
+            }
+            remove((prefix + "_coordinator.log").c_str());
+        }
+        cout << "\n\t" << left << setw(10) << threads << setw(18) << rates[0] << setw(18) << rates[1];
+        setConsoleColor(exact ? 10 : 12);
+        cout << (exact ? "exact" : "MISMATCH");
         setConsoleColor(7);
-        cout << "\n\n\tPress any key to return to menu...";
-        _getch();
-        showCustomerMenu();
-        return;
+        cout.flush();
     }
+    remove("Bench_Source.csv");
+}
 
-    cout << "\n\tEnter Recipient Account Number: ";
-    cin >> to_acc_no;
+// Measures transfer throughput on a synthetic book for 1, 2, 4 and 8 shards, one worker thread
+// per shard. Each worker sends from accounts of "its" shard; 10% of transfers cross shards.
+void runShardBenchmark(bool sync_journals)
+{
+    const size_t ACCOUNTS = 20000;
+    const size_t TRANSFERS = 40000;
+    const string prefix = "Bench_Shard";
 
-    AccountNode *to_account = search(root, to_acc_no);
-    if (to_account == nullptr)
     {
-        setConsoleColor(12);
-        cout << "\n\tRecipient Account Doesn't Exist!";
-        setConsoleColor(7);
-        cout << "\n\n\tPress any key to return to menu...";
-        _getch();
-        showCustomerMenu();
-        return;
+        ofstream source("Bench_Source.csv");
+        string creation_date = getCurrentDateTime();
+        vector<size_t> order(ACCOUNTS);
+        for (size_t i = 0; i < ACCOUNTS; i++)
+            order[i] = i;
+        shuffle(order.begin(), order.end(), mt19937(42)); // Unsorted input keeps the shard trees shallow
+        for (size_t i : order)
+        {
+            source << 10000000 + i << ",Bench,01/01/2000,25,Bench Street,0000000000,1000000.00,Saving,"
+                   << creation_date << "," << creation_date << "\n";
+        }
     }
 
-    // Prevent transferring to the same account
-    if (from_acc_no == to_acc_no) {
-        setConsoleColor(12);
-        cout << "\n\tCannot transfer to the same account!";
-        setConsoleColor(7);
-        cout << "\n\n\tPress any key to return to menu...";
-        _getch();
-        showCustomerMenu();
-        return;
+    setConsoleColor(14);
+    cout << "\n\t" << left << setw(10) << "Shards" << setw(16) << "Transfers/s" << "Cross-shard";
+    setConsoleColor(7);
+    for (size_t shard_count = 1; shard_count <= 8; shard_count *= 2)
+    {
+        ShardedBank::splitBook("Bench_Source.csv", shard_count, prefix);
+        double seconds;
+        size_t cross_total = 0;
+        {
+            ShardedBank book(shard_count, prefix, sync_journals);
+            vector<vector<string>> by_shard(shard_count);
+            for (size_t i = 0; i < ACCOUNTS; i++)
+            {
+                string acc_no = to_string(10000000 + i);
+                by_shard[book.shardOf(acc_no)].push_back(acc_no);
+            }
+
+            vector<size_t> cross(shard_count, 0);
+            auto started = chrono::steady_clock::now();
+            vector<thread> workers;
+            for (size_t w = 0; w < shard_count; w++)
+            {
+                workers.emplace_back([&, w]()
+                {
+                    mt19937 random(static_cast<unsigned>(w + 1));
+                    const vector<string> &home = by_shard[w];
+                    for (size_t t = 0; t < TRANSFERS / shard_count; t++)
+                    {
+                        const string &from = home[random() % home.size()];
+                        bool remote = shard_count > 1 && random() % 10 == 0;
+                        const vector<string> &targets = remote ? by_shard[(w + 1 + random() % (shard_count - 1)) % shard_count] : home;
+                        const string &to = targets[random() % targets.size()];
+                        if (book.transfer(from, to, 100) == TxnStatus::Ok && remote)
+                            cross[w]++;
+                    }
+                });
+            }
+            for (thread &worker : workers)
+                worker.join();
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+            for (size_t c : cross)
+                cross_total += c;
+        }
+        cout << "\n\t" << left << setw(10) << shard_count << setw(16) << static_cast<long long>(TRANSFERS / seconds) << cross_total;
+        cout.flush();
+
+        for (size_t i = 0; i < shard_count; i++)
+        {
+            remove((prefix + "_" + to_string(i) + "_Record.csv").c_str());
+            remove((prefix + "_" + to_string(i) + ".journal").c_str());
+        }
+        remove((prefix + "_coordinator.log").c_str());
     }
+    remove("Bench_Source.csv");
+}
 
+// Employee screen for the velocity limits, with a micro-benchmark of the rule engine
+void manageVelocityRules()
+{
+    displayAppTitle();
+    cout << "\n\t\tVELOCITY LIMITS (WITHDRAWALS AND TRANSFERS)\n";
 
-    cout << "\n\tEnter Amount to Transfer: Rs ";
-    while (!(cin >> amount) || amount <= 0) {
+    VelocityRules &rules = velocityMonitor.rules;
+    static const char *window_names[VELOCITY_WINDOWS] = {"Minute", "Hour", "Day"};
+    for (int w = 0; w < VELOCITY_WINDOWS; w++)
+    {
+        cout << "\n\tPer " << left << setw(8) << window_names[w] << "max count: " << setw(8)
+             << (rules.max_count[w] ? to_string(rules.max_count[w]) : "-") << " max amount: "
+             << (rules.max_amount[w] ? "Rs " + formatPaise(rules.max_amount[w]) : "-");
+    }
+    cout << "\n\tDistinct recipients per day: " << (rules.max_counterparties_day ? to_string(rules.max_counterparties_day) : "-");
+    cout << "\n\tAccounts with recent outflows: " << velocityMonitor.trackedAccounts();
+
+    int choice;
+    cout << "\n\n\t1. Change Limits\n\t2. Run Rule Engine Benchmark\n\t3. Return to Employee Menu\n\tChoice: ";
+    while (!(cin >> choice) || choice < 1 || choice > 3) {
         setConsoleColor(12);
-        cout << "\n\tInvalid amount. Please enter a positive number: Rs ";
+        cout << "\n\tInvalid choice. Please enter 1, 2, or 3: ";
         setConsoleColor(7);
         cin.clear();
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
 
-    float from_balance = stof(from_account->balance);
-    if (amount > from_balance)
+    if (choice == 1)
     {
-        setConsoleColor(12);
-        cout << "\n\tInsufficient Balance in Sender Account!";
+        auto readLimit = [](const string &prompt, long long most) -> long long
+        {
+            long long value;
+            cout << "\n\t" << prompt << " (0 for no limit): ";
+            while (!(cin >> value) || value < 0 || value > most) {
+                setConsoleColor(12);
+                cout << "\n\tInvalid value. Please enter a number between 0 and " << most << ": ";
+                setConsoleColor(7);
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            }
+            return value;
+        };
+        for (int w = 0; w < VELOCITY_WINDOWS; w++)
+        {
+            rules.max_count[w] = static_cast<int>(readLimit(string("Max transactions per ") + window_names[w], 1000000));
+            rules.max_amount[w] = readLimit(string("Max amount per ") + window_names[w] + " in Rs", 1000000000000LL) * 100;
+        }
+        rules.max_counterparties_day = static_cast<int>(readLimit("Max distinct recipients per day", MAX_TRACKED_COUNTERPARTIES));
+        if (saveVelocityRules(rules))
+        {
+            setConsoleColor(10);
+            cout << "\n\tVelocity limits saved.";
+        }
+        else
+        {
+            setConsoleColor(12);
+            cout << "\n\tError: Could not save Velocity_rules.csv.";
+        }
         setConsoleColor(7);
     }
+    else if (choice == 2)
+    {
+        // Scratch engine with the current limits: 1M outflows over 100k accounts, the clock advancing 1 s per 1000
+        const int ACCOUNTS = 100000, OPERATIONS = 1000000;
+        VelocityMonitor engine;
+        engine.rules = rules;
+        vector<string> accounts(ACCOUNTS);
+        for (int i = 0; i < ACCOUNTS; i++)
+            accounts[i] = to_string(1000000000LL + i);
+        vector<unsigned> picks(3 * OPERATIONS);
+        mt19937 rng(7);
+        for (unsigned &pick : picks)
+            pick = rng();
+        const string no_counterparty;
+        time_t now = time(0);
+        size_t blocked = 0;
+        auto started = chrono::steady_clock::now();
+        for (int i = 0; i < OPERATIONS; i++)
+        {
+            const string &from = accounts[picks[3 * i] % ACCOUNTS];
+            const string &to = i % 2 ? accounts[picks[3 * i + 1] % ACCOUNTS] : no_counterparty;
+            if (engine.admit(from, 100 + picks[3 * i + 2] % 500000, to, now + i / 1000) != nullptr)
+                blocked++;
+        }
+        double elapsed_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - started).count();
+        cout << "\n\tChecked " << OPERATIONS << " outflows in " << fixed << setprecision(1) << elapsed_ns / 1e6 << " ms ("
+             << elapsed_ns / OPERATIONS << " ns each), " << blocked << " blocked.";
+        cout.unsetf(ios::floatfield);
+        cout << setprecision(6);
+    }
     else
     {
-        from_balance -= amount;
-        from_account->balance = to_string(from_balance);
-
-        float to_balance = stof(to_account->balance);
-        to_balance += amount;
-        to_account->balance = to_string(to_balance);
-
-        string transaction_time = getCurrentDateTime();
-        from_account->last_transaction = transaction_time;
-        to_account->last_transaction = transaction_time;
-
-        string trans_sender = "Transfer Out: -Rs " + to_string(amount) + " to " + to_acc_no + " (From " + from_acc_no + ")";
-        string trans_receiver = "Transfer In: +Rs " + to_string(amount) + " from " + from_acc_no + " (To " + to_acc_no + ")";
-
-        transactionHistory.push_back(trans_sender);
-        transactionHistory.push_back(trans_receiver);
-        recentTransactions.push(trans_sender);
-        recentTransactions.push(trans_receiver);
-
-        saveAccountsToFile(); // Save updated balances and last transaction dates
-
-        setConsoleColor(10);
-        cout << "\n\tTransfer Successful!";
-        cout << "\n\tYour New Balance (Sender): Rs " << from_account->balance;
-        setConsoleColor(7);
+        showEmployeeMenu();
+        return;
     }
 
     cout << "\n\n\tPress any key to return to menu...";
-    _getch();
-    showCustomerMenu();
+    readKey();
+    manageVelocityRules();
 }
 
-
-void Bank::viewTransactionHistory()
+// Times the password hash at a few costs, the worker pool at the current cost, and token lookups
+void runLoginBenchmark()
 {
-    displayAppTitle();
-    cout << "\n\t\tTRANSACTION HISTORY\n";
-
-    if (recentTransactions.empty()) // Use recentTransactions for user display
+    setConsoleColor(14);
+    cout << "\n\n\tPassword hashing (one core)";
+    setConsoleColor(7);
+    vector<unsigned> costs = {10000, 100000, 300000};
+    if (find(costs.begin(), costs.end(), passwordIterations.load()) == costs.end())
+        costs.push_back(passwordIterations);
+    sort(costs.begin(), costs.end());
+    for (unsigned cost : costs)
     {
-        setConsoleColor(12);
-        cout << "\n\tNo recent transactions to display.";
-        setConsoleColor(7);
+        // Repeat until a quarter second has passed so cheap costs are measured over many hashes
+        int hashes = 0;
+        auto started = chrono::steady_clock::now();
+        double elapsed_ms = 0;
+        while (hashes < 2 || elapsed_ms < 250)
+        {
+            hashPassword("benchmark", cost);
+            hashes++;
+            elapsed_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+        }
+        cout << "\n\t" << right << setw(9) << cost << " iterations: " << fixed << setprecision(1) << elapsed_ms / hashes
+             << " ms per login, " << 1000.0 * hashes / elapsed_ms << " logins/s" << (cost == passwordIterations ? "  (current)" : "");
     }
-    else
-    {
-        setConsoleColor(14);
-        cout << "\n\tLast 10 Recent Transactions (newest first):";
-        setConsoleColor(7);
-        cout << "\n\t--------------------------------------------------\n";
 
-        stack<string> tempStack = recentTransactions; // Use a temporary stack
-        int count = 0;
-
-        while (!tempStack.empty() && count < 10) // Display up to 10
+    // Pool throughput: enough checks to keep every worker busy for a while
+    size_t workers = passwordWorkers.threadCount();
+    const size_t CHECKS = workers * 8;
+    const string stored = hashPassword("benchmark");
+    mutex lock;
+    condition_variable finished;
+    size_t remaining = CHECKS, accepted = 0;
+    auto started = chrono::steady_clock::now();
+    for (size_t i = 0; i < CHECKS; i++)
+    {
+        bool queued = passwordWorkers.trySubmit([&]()
         {
-            cout << "\t" << tempStack.top() << "\n";
-            tempStack.pop();
-            count++;
-        }
-        if (recentTransactions.size() > 10) {
-            cout << "\n\t(More transactions available, showing last 10)";
+            bool valid = checkPassword(stored, "benchmark").valid;
+            lock_guard<mutex> guard(lock);
+            accepted += valid;
+            if (--remaining == 0)
+                finished.notify_one();
+        });
+        if (!queued)
+        {
+            lock_guard<mutex> guard(lock);
+            remaining--;
         }
     }
+    {
+        unique_lock<mutex> guard(lock);
+        finished.wait(guard, [&]() { return remaining == 0; });
+    }
+    double pool_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+    setConsoleColor(14);
+    cout << "\n\n\tVerification pool (" << workers << " workers, current cost)";
+    setConsoleColor(7);
+    cout << "\n\t" << accepted << " of " << CHECKS << " logins verified in " << pool_ms << " ms, "
+         << 1000.0 * accepted / pool_ms << " logins/s";
 
-    cout << "\n\n\tPress any key to return to menu...";
-    _getch();
-    showCustomerMenu();
+    // Session tokens: the per-connection cost once a client holds one
+    const size_t TOKENS = 100000, LOOKUPS = 1000000;
+    SessionTokens tokens;
+    time_t now = time(0);
+    vector<string> issued;
+    issued.reserve(TOKENS);
+    for (size_t i = 0; i < TOKENS; i++)
+        issued.push_back(tokens.issue(to_string(1000000000LL + i), now));
+    size_t found = 0;
+    started = chrono::steady_clock::now();
+    for (size_t i = 0; i < LOOKUPS; i++)
+        found += tokens.find(issued[(i * 7919) % TOKENS], now) != nullptr;
+    double lookup_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - started).count();
+    setConsoleColor(14);
+    cout << "\n\n\tSession tokens";
+    setConsoleColor(7);
+    cout << "\n\t" << found << " lookups among " << TOKENS << " live tokens, " << lookup_ns / LOOKUPS << " ns each";
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
 }
 
-
-void Bank::submitServiceRequest()
+// Employee screen for the password hashing cost and the migration of plaintext credentials
+void manageLoginSecurity()
 {
     displayAppTitle();
-    cout << "\n\t\tREQUEST CUSTOMER SERVICE\n";
-
-    string acc_no, request_description;
-    cout << "\n\tEnter Your Account Number: ";
-    cin >> acc_no;
+    cout << "\n\t\tLOGIN SECURITY\n";
 
-    AccountNode *account = search(root, acc_no);
-    if (account == nullptr)
+    // Credentials still stored as plaintext (from before hashing) or hashed at another cost
+    vector<string *> plaintext;
+    size_t other_cost = 0;
+    for (map<string, string> *credentials : {&employeeCredentials, &accountCredentials})
     {
+        for (auto &entry : *credentials)
+        {
+            string salt_hex, hash_hex;
+            unsigned iterations = storedPasswordIterations(entry.second, salt_hex, hash_hex);
+            if (iterations == 0)
+                plaintext.push_back(&entry.second);
+            else if (iterations != passwordIterations)
+                other_cost++;
+        }
+    }
+    cout << "\n\tHashing: PBKDF2-HMAC-SHA256, " << passwordIterations << " iterations";
+    cout << "\n\tVerification workers: " << passwordWorkers.threadCount();
+    cout << "\n\tPlaintext passwords: " << plaintext.size();
+    cout << "\n\tHashed at another cost (rehashed at next login): " << other_cost;
+
+    int choice;
+    cout << "\n\n\t1. Change Hashing Cost\n\t2. Hash Remaining Plaintext Passwords\n\t3. Run Login Benchmark\n\t4. Return to Employee Menu\n\tChoice: ";
+    while (!(cin >> choice) || choice < 1 || choice > 4) {
         setConsoleColor(12);
-        cout << "\n\tAccount Doesn't Exist!";
+        cout << "\n\tInvalid choice. Please enter 1, 2, 3, or 4: ";
         setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
-    else
+
+    if (choice == 1)
     {
-        int service_choice;
-        cout << "\n\tSelect service type:";
-        cout << "\n\t1. Technical Issue";
-        cout << "\n\t2. Account Query";
-        cout << "\n\t3. Loan Information";
-        cout << "\n\t4. Other";
-        cout << "\n\tChoice: ";
-        while (!(cin >> service_choice) || (service_choice < 1 || service_choice > 4)) {
+        unsigned long iterations;
+        cout << "\n\tIterations (1000 to 10000000): ";
+        while (!(cin >> iterations) || iterations < 1000 || iterations > 10000000) {
             setConsoleColor(12);
-            cout << "\n\tInvalid choice. Please enter a number between 1 and 4: ";
+            cout << "\n\tInvalid value. Please enter a number between 1000 and 10000000: ";
             setConsoleColor(7);
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
         }
-        cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Clear buffer before getline
-
-        string service_type_str;
-        switch (service_choice)
+        if (savePasswordCost(static_cast<unsigned>(iterations)))
         {
-        case 1: service_type_str = "Technical Issue"; break;
-        case 2: service_type_str = "Account Query";   break;
-        case 3: service_type_str = "Loan Information"; break;
-        case 4:
-        default: service_type_str = "Other"; break;
+            passwordIterations = static_cast<unsigned>(iterations);
+            setConsoleColor(10);
+            cout << "\n\tHashing cost saved. Existing passwords move to it as their owners log in.";
+        }
+        else
+        {
+            setConsoleColor(12);
+            cout << "\n\tError: Could not save Password_config.csv.";
         }
-
-        cout << "\n\tPlease describe your request (single line): ";
-        getline(cin, request_description);
-
-        string service_request_string = getCurrentDateTime() + " | Account: " + acc_no + " | Name: " + account->name + " | Type: " + service_type_str + " | Desc: " + request_description;
-        serviceQueue.push(service_request_string);
-
-        setConsoleColor(10);
-        cout << "\n\tYour service request has been queued!";
-        cout << "\n\tCurrent queue position: " << serviceQueue.size();
         setConsoleColor(7);
     }
+    else if (choice == 2)
+    {
+        if (plaintext.empty())
+        {
+            cout << "\n\tNo plaintext passwords left.";
+        }
+        else
+        {
+            // Each hash is deliberately slow, so even a short list is worth spreading over every core
+            size_t hardware = max(1u, thread::hardware_concurrency());
+            auto started = chrono::steady_clock::now();
+            runParallelChunks(plaintext.size(), min(hardware, plaintext.size()), [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t i = begin; i < end; i++)
+                    *plaintext[i] = hashPassword(*plaintext[i]);
+            });
+            double elapsed_s = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+            saveAllCredentials();
+            setConsoleColor(10);
+            cout << "\n\tHashed " << plaintext.size() << " passwords in " << fixed << setprecision(1) << elapsed_s << " s.";
+            cout.unsetf(ios::floatfield);
+            cout << setprecision(6);
+            setConsoleColor(7);
+        }
+    }
+    else if (choice == 3)
+    {
+        runLoginBenchmark();
+    }
+    else
+    {
+        showEmployeeMenu();
+        return;
+    }
 
     cout << "\n\n\tPress any key to return to menu...";
-    _getch();
-    showCustomerMenu();
+    readKey();
+    manageLoginSecurity();
 }
 
 
-void Bank::manageServiceQueue()
+// Employee tools for the sharded account book
+void manageShardedBook()
 {
     displayAppTitle();
-    cout << "\n\t\tSERVICE QUEUE MANAGEMENT\n";
+    cout << "\n\t\tSHARDED ACCOUNT BOOK\n";
+    size_t shard_count = loadShardCount();
+    if (shard_count == 0)
+        cout << "\n\tThe book has not been split into shards yet.";
+    else
+        cout << "\n\tShards: " << shard_count;
+    vector<string> hot_accounts = loadHotAccounts();
+    cout << "\n\tHot accounts: ";
+    if (hot_accounts.empty())
+        cout << "none";
+    for (size_t i = 0; i < hot_accounts.size(); i++)
+        cout << (i ? ", " : "") << hot_accounts[i];
 
-    if (serviceQueue.empty())
-    {
+    int choice;
+    cout << "\n\n\t1. Split Bank_Record.csv into Shards\n\t2. Transfer Funds on the Sharded Book\n\t3. Run Shard Scaling Benchmark"
+         << "\n\t4. Designate or Release a Hot Account\n\t5. Run Hot Account Benchmark\n\t6. Return to Employee Menu\n\tChoice: ";
+    while (!(cin >> choice) || choice < 1 || choice > 6) {
         setConsoleColor(12);
-        cout << "\n\tNo pending service requests.";
+        cout << "\n\tInvalid choice. Please enter a number between 1 and 6: ";
         setConsoleColor(7);
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
-    else
+
+    if (choice == 1)
     {
-        setConsoleColor(14);
-        cout << "\n\tPending Service Requests: " << serviceQueue.size();
+        size_t new_count;
+        cout << "\n\tNumber of shards (1-64): ";
+        while (!(cin >> new_count) || new_count == 0 || new_count > 64) {
+            setConsoleColor(12);
+            cout << "\n\tInvalid value. Please enter a number between 1 and 64: ";
+            setConsoleColor(7);
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        size_t written = ShardedBank::splitBook("Bank_Record.csv", new_count, "Shard");
+        ofstream("Shard_config.csv") << new_count << "\n";
+        setConsoleColor(10);
+        cout << "\n\t" << written << " account(s) distributed over " << new_count << " shard(s).";
         setConsoleColor(7);
-        cout << "\n\t--------------------------------------------------\n";
-        cout << "\n\tNext in queue: " << serviceQueue.front();
-
-        int queue_action_choice;
-        cout << "\n\n\tWhat would you like to do?";
-        cout << "\n\t1. Process Next Request";
-        cout << "\n\t2. View All Requests in Queue";
-        cout << "\n\t3. Return to Employee Menu";
-        cout << "\n\tChoice: ";
-        while (!(cin >> queue_action_choice) || (queue_action_choice < 1 || queue_action_choice > 3)) {
+    }
+    else if (choice == 2 && shard_count > 0)
+    {
+        string from_acc_no, to_acc_no;
+        float amount;
+        cout << "\n\tEnter Sender Account Number: ";
+        cin >> from_acc_no;
+        cout << "\n\tEnter Recipient Account Number: ";
+        cin >> to_acc_no;
+        cout << "\n\tEnter Amount to Transfer: Rs ";
+        while (!(cin >> amount) || amount <= 0) {
             setConsoleColor(12);
-            cout << "\n\tInvalid choice. Please enter 1, 2, or 3: ";
+            cout << "\n\tInvalid amount. Please enter a positive number: Rs ";
             setConsoleColor(7);
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
         }
-
-        if (queue_action_choice == 1)
+        ShardedBank book(shard_count, "Shard", true, hot_accounts);
+        TxnStatus status = book.transfer(from_acc_no, to_acc_no, llround(amount * 100.0));
+        long long balance = 0;
+        if (status == TxnStatus::Ok && book.balanceOf(from_acc_no, balance))
         {
-            cout << "\n\tProcessing request: " << serviceQueue.front();
-            serviceQueue.pop();
             setConsoleColor(10);
-            cout << "\n\tRequest processed successfully!";
-            setConsoleColor(7);
-            cout << "\n\tRemaining requests: " << serviceQueue.size();
-            cout << "\n\n\tPress any key to continue...";
-            _getch();
-            manageServiceQueue(); // Recurse to process more or return
+            cout << "\n\tTransfer Successful! (" << (book.shardOf(from_acc_no) == book.shardOf(to_acc_no) ? "same shard" : "cross-shard")
+                 << ")\n\tSender New Balance: Rs " << formatPaise(balance);
         }
-        else if (queue_action_choice == 2)
+        else
         {
-            queue<string> tempQueue = serviceQueue;
-            int count = 1;
-
-            cout << "\n\n\tAll pending requests:";
-            while (!tempQueue.empty())
-            {
-                cout << "\n\t" << count << ". " << tempQueue.front();
-                tempQueue.pop();
-                count++;
-            }
-            cout << "\n\n\tPress any key to return...";
-            _getch();
-            manageServiceQueue(); // Return to queue options
+            setConsoleColor(12);
+            cout << "\n\t" << txnStatusMessage(status);
+        }
+        setConsoleColor(7);
+    }
+    else if (choice == 2)
+    {
+        setConsoleColor(12);
+        cout << "\n\tSplit the book into shards first.";
+        setConsoleColor(7);
+    }
+    else if (choice == 3)
+    {
+        char sync_choice;
+        cout << "\n\tSync journals to disk on every transfer? (y/n): ";
+        cin >> sync_choice;
+        runShardBenchmark(sync_choice == 'y' || sync_choice == 'Y');
+    }
+    else if (choice == 4)
+    {
+        string acc_no;
+        cout << "\n\tEnter Account Number (a hot account is released, any other becomes hot): ";
+        cin >> acc_no;
+        auto existing = find(hot_accounts.begin(), hot_accounts.end(), acc_no);
+        bool released = existing != hot_accounts.end();
+        if (released)
+            hot_accounts.erase(existing);
+        else
+            hot_accounts.push_back(acc_no);
+        if (saveHotAccounts(hot_accounts))
+        {
+            setConsoleColor(10);
+            cout << "\n\tAccount " << acc_no << (released ? " is no longer hot." : " is now hot. Credits to it are merged lazily.");
+        }
+        else
+        {
+            setConsoleColor(12);
+            cout << "\n\tError: Could not save Hot_accounts.csv.";
         }
+        setConsoleColor(7);
+    }
+    else if (choice == 5)
+    {
+        runHotAccountBenchmark();
     }
 
-    cout << "\n\n\tPress any key to return to menu...";
-    _getch();
-    showEmployeeMenu(); // Always return to employee menu from here
+    if (choice != 6)
+    {
+        cout << "\n\n\tPress any key to return to menu...";
+        readKey();
+    }
+    showEmployeeMenu();
 }
 
 
@@ -1194,7 +10009,8 @@ void showCustomerMenu()
     cout << "\n\t5. Transfer Funds";
     cout << "\n\t6. View Transaction History";
     cout << "\n\t7. Request Customer Service";
-    cout << "\n\t8. Log Out";
+    cout << "\n\t8. Standing Orders";
+    cout << "\n\t9. Log Out";
     cout << "\n\t0. Exit Application";
     cout << "\n\n\tEnter your choice: ";
 
@@ -1213,7 +10029,8 @@ void showCustomerMenu()
     case 5: bank_operations.performFundTransfer(); break;
     case 6: bank_operations.viewTransactionHistory(); break;
     case 7: bank_operations.submitServiceRequest(); break;
-    case 8: showLoadingScreen(); main(); break; // Log out returns to main menu
+    case 8: bank_operations.manageStandingOrders(); break;
+    case 9: showLoadingScreen(); main(); break; // Log out returns to main menu
     case 0: close_application(); break;
     default:
         setConsoleColor(12);
@@ -1239,7 +10056,15 @@ void showEmployeeMenu()
     cout << "\n\t4. View All Bank Accounts";
     cout << "\n\t5. Process Customer Service Requests";
     cout << "\n\t6. Add New Employee Account";
-    cout << "\n\t7. Log Out";
+    cout << "\n\t7. Analytics Dashboard";
+    cout << "\n\t8. Interest Posting";
+    cout << "\n\t9. Sharded Account Book";
+    cout << "\n\t10. Velocity Limits";
+    cout << "\n\t11. Statements and Archive";
+    cout << "\n\t12. Bulk Import/Export";
+    cout << "\n\t13. Standing Orders";
+    cout << "\n\t14. Login Security";
+    cout << "\n\t15. Log Out";
     cout << "\n\t0. Exit Application";
     cout << "\n\n\tEnter your choice: ";
 
@@ -1276,7 +10101,7 @@ void showEmployeeMenu()
                 cout << "\n\tEnter Password for New Employee: ";
                 password = getSecurePasswordInput();
 
-                employeeCredentials[emp_id] = password; // Add to map
+                employeeCredentials[emp_id] = hashPassword(password); // Add to map
                 saveAllCredentials(); // Save updated employee credentials
 
                 setConsoleColor(10);
@@ -1284,11 +10109,24 @@ void showEmployeeMenu()
                 setConsoleColor(7);
             }
             cout << "\n\n\tPress any key to return to menu...";
-            _getch();
+            readKey();
             showEmployeeMenu(); // Return to employee menu
         }
         break;
-    case 7: showLoadingScreen(); main(); break; // Log out
+    case 7: bank_operations.showAnalyticsDashboard(); break;
+    case 8: bank_operations.manageInterestPosting(); break;
+    case 9: manageShardedBook(); break;
+    case 10: manageVelocityRules(); break;
+    case 11: bank_operations.manageStatements(); break;
+    case 12: bank_operations.manageBulkTransfer(); break;
+    case 13: bank_operations.manageStandingOrderRuns(); break;
+    case 14: manageLoginSecurity(); break;
+    case 15: // Log out
+        serviceDesk.closeDesk(serviceDesk.deskOf(currentEmployee));
+        currentEmployee.clear();
+        showLoadingScreen();
+        main();
+        break;
     case 0: close_application(); break;
     default:
         setConsoleColor(12);
@@ -1302,7 +10140,6 @@ void showEmployeeMenu()
 // Employee Login function
 void employeeLogin()
 {
-    system("cls");
     displayAppTitle();
 
     string emp_id, password;
@@ -1312,11 +10149,22 @@ void employeeLogin()
     cout << "\n\tEnter Password: ";
     password = getSecurePasswordInput();
 
-    if (employeeCredentials.count(emp_id) && employeeCredentials[emp_id] == password)
+    // Unknown IDs are checked against a dummy hash so they take as long as a wrong password
+    auto credentials = employeeCredentials.find(emp_id);
+    bool known = credentials != employeeCredentials.end();
+    PasswordCheck check = checkPassword(known ? credentials->second : unknownUserPasswordHash(), password);
+    if (known && check.valid)
     {
+        if (!check.rehashed.empty()) // Plaintext or an old cost: store a current hash
+        {
+            credentials->second = check.rehashed;
+            saveAllCredentials();
+        }
         setConsoleColor(10);
         cout << "\n\tLogin Successful! Welcome, " << emp_id << "!";
         setConsoleColor(7);
+        currentEmployee = emp_id;
+        serviceDesk.openDesk(emp_id); // On duty at the service desk until logout
         fordelay(1000); // Shorter delay
         showEmployeeMenu(); // Go to employee menu
     }
@@ -1343,7 +10191,6 @@ void employeeLogin()
 // Customer Login function
 void customerLogin()
 {
-    system("cls");
     displayAppTitle();
 
     string acc_no, password;
@@ -1353,8 +10200,16 @@ void customerLogin()
     cout << "\n\tEnter Password: ";
     password = getSecurePasswordInput();
 
-    if (accountCredentials.count(acc_no) && accountCredentials[acc_no] == password)
+    auto credentials = accountCredentials.find(acc_no);
+    bool known = credentials != accountCredentials.end();
+    PasswordCheck check = checkPassword(known ? credentials->second : unknownUserPasswordHash(), password);
+    if (known && check.valid)
     {
+        if (!check.rehashed.empty())
+        {
+            credentials->second = check.rehashed;
+            saveAllCredentials();
+        }
         setConsoleColor(10);
         cout << "\n\tLogin Successful!";
         setConsoleColor(7);
@@ -1384,8 +10239,24 @@ void customerLogin()
 // Main function - entry point of the application
 int main()
 {
-    // Load credentials and account data at startup
+    terminal.attach();
+    // Load credentials, the ledger and account data at startup. The account records load on
+    // their own thread while the credentials and ledger are read here.
+    unique_ptr<Bank> scheduled_jobs;
+    thread records_loader([&scheduled_jobs]() { scheduled_jobs = make_unique<Bank>(); });
+    passwordIterations = loadPasswordCost(); // Before credentials, which may create the default admin
     loadAllCredentials();
+    recoverStandingOrderRun();
+    loadTransactionLedger();
+    recoverInterestRun();
+    standingOrders.load("Standing_orders.csv", time(0));
+    velocityMonitor.rules = loadVelocityRules();
+    velocityMonitor.prime(transactionLedger, time(0));
+    records_loader.join();
+    scheduled_jobs->runScheduledInterest(); // Post any interest that fell due while the application was closed
+    size_t orders_executed, orders_failed;
+    scheduled_jobs->runDueStandingOrders(time(0), orders_executed, orders_failed); // Likewise for standing orders
+    scheduled_jobs.reset();
     srand(time(0)); // Seed random number generator
 
     showLoadingScreen();
@@ -1397,13 +10268,14 @@ int main()
 
     cout << "\n\t1. Login";
     cout << "\n\t2. Instructions";
+    cout << "\n\t3. Server Mode";
     cout << "\n\t0. Exit";
     cout << "\n\n\tEnter your choice: ";
 
     int main_choice;
-    while (!(cin >> main_choice) || (main_choice < 0 || main_choice > 2)) {
+    while (!(cin >> main_choice) || (main_choice < 0 || main_choice > 3)) {
         setConsoleColor(12);
-        cout << "\n\tInvalid choice. Please enter 1, 2, or 0: ";
+        cout << "\n\tInvalid choice. Please enter 1, 2, 3, or 0: ";
         setConsoleColor(7);
         cin.clear();
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -1442,6 +10314,9 @@ int main()
         showInstructions();
         main(); // Return to main menu after showing instructions
         break;
+    case 3:
+        showServerMenu();
+        break;
     case 0:
         close_application();
         break;